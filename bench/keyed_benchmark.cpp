@@ -0,0 +1,83 @@
+// Push and pop-all of 2M shuffled pointers to 256-byte nodes, comparing DynamicPriorityQueue, which dereferences the
+// nodes on every comparison, with KeyedDynamicPriorityQueue, which compares its cached keys. Build with
+// -DCMAKE_BUILD_TYPE=Release. On a shared single-core machine three runs of the same build took 4448-4611 ms and
+// 1938-2301 ms; the keyed queue was about twice as fast in every run.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../include/dynamic_priority_queue.hpp"
+#include "../include/keyed_dynamic_priority_queue.hpp"
+
+namespace {
+
+// Large enough that every node the heap touches is its own cache miss.
+struct Node {
+    long long key;
+    std::size_t index;
+    char padding[240];
+};
+
+struct IndexFunction {
+    std::size_t& operator()(Node* node) { return node->index; }
+    std::size_t operator()(const Node* node) const { return node->index; }
+};
+
+struct NodeCompare {
+    int operator()(const Node* lhs, const Node* rhs) const {
+        if (lhs->key < rhs->key)
+            return -1;
+        if (lhs->key > rhs->key)
+            return 1;
+        return 0;
+    }
+};
+
+struct NodeKey {
+    long long operator()(const Node* node) const { return node->key; }
+};
+
+double milliseconds(const std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename Queue>
+void run(const char* name, std::vector<Node>& nodes, const std::vector<Node*>& order) {
+    std::mt19937_64 random(42);
+    for (auto& node : nodes) {
+        node.key = static_cast<long long>(random() % 1000000000);
+        node.index = std::numeric_limits<std::size_t>::max();
+    }
+
+    Queue queue;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (Node* node : order) {
+        queue.push(node);
+    }
+    long long checksum = 0;
+    while (!queue.empty()) {
+        checksum += queue.pop()->key;
+    }
+
+    std::printf("%s: push + pop-all %.0f ms (checksum %lld)\n", name, milliseconds(start), checksum);
+}
+
+} // namespace
+
+int main() {
+    std::vector<Node> nodes(2000000);
+    std::vector<Node*> order;
+    order.reserve(nodes.size());
+    for (auto& node : nodes) {
+        order.push_back(&node);
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(7));
+
+    run<cserna::DynamicPriorityQueue<Node*, IndexFunction, NodeCompare>>("DynamicPriorityQueue", nodes, order);
+    run<cserna::KeyedDynamicPriorityQueue<Node*, IndexFunction, NodeKey>>("KeyedDynamicPriorityQueue", nodes, order);
+}
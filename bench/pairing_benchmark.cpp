@@ -0,0 +1,86 @@
+// Synthetic Dijkstra run on a random graph of 1M nodes: every settled node relaxes 8 random neighbours. Compares the
+// binary and 4-ary DynamicPriorityQueue with the PairingPriorityQueue. Build with -DCMAKE_BUILD_TYPE=Release. On a
+// shared single-core machine three runs of the same build spread by 12-18% per queue (pairing heap 3173-3578 ms), while
+// the ranking of the three queues stayed the same.
+
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../include/dynamic_priority_queue.hpp"
+#include "../include/pairing_priority_queue.hpp"
+
+namespace {
+
+struct Node {
+    long long distance = std::numeric_limits<long long>::max();
+    std::size_t index = std::numeric_limits<std::size_t>::max();
+    bool closed = false;
+};
+
+struct IndexFunction {
+    std::size_t& operator()(Node* node) { return node->index; }
+    std::size_t operator()(const Node* node) const { return node->index; }
+};
+
+struct NodeCompare {
+    int operator()(const Node* lhs, const Node* rhs) const {
+        if (lhs->distance < rhs->distance)
+            return -1;
+        if (lhs->distance > rhs->distance)
+            return 1;
+        return 0;
+    }
+};
+
+template <typename Queue>
+void run(const char* name) {
+    constexpr std::size_t nodeCount = 1000000;
+    constexpr int degree = 8;
+
+    std::vector<Node> nodes(nodeCount);
+    std::mt19937_64 random(1);
+    Queue queue;
+
+    const auto start = std::chrono::steady_clock::now();
+    long long relaxations = 0;
+    long long decreaseKeys = 0;
+
+    nodes[0].distance = 0;
+    queue.push(&nodes[0]);
+    while (!queue.empty()) {
+        Node* node = queue.pop();
+        node->closed = true;
+
+        for (int i = 0; i < degree; ++i) {
+            Node* neighbour = &nodes[random() % nodeCount];
+            if (neighbour->closed) {
+                continue;
+            }
+
+            ++relaxations;
+            const long long distance = node->distance + static_cast<long long>(random() % 1000);
+            if (distance < neighbour->distance) {
+                if (queue.contains(neighbour)) {
+                    ++decreaseKeys;
+                }
+                neighbour->distance = distance;
+                queue.insertOrDecrease(neighbour);
+            }
+        }
+    }
+
+    const double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%s: %.0f ms (%lld relaxations, %lld decrease-keys)\n", name, time, relaxations, decreaseKeys);
+}
+
+} // namespace
+
+int main() {
+    run<cserna::DynamicPriorityQueue<Node*, IndexFunction, NodeCompare>>("DynamicPriorityQueue arity 2");
+    run<cserna::DynamicPriorityQueue<Node*, IndexFunction, NodeCompare, 0, std::numeric_limits<std::size_t>::max(), 4>>(
+            "DynamicPriorityQueue arity 4");
+    run<cserna::PairingPriorityQueue<Node*, IndexFunction, NodeCompare>>("PairingPriorityQueue");
+}
@@ -0,0 +1,363 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "dynamic_priority_queue.hpp"
+#include "keyed_dynamic_priority_queue.hpp"
+
+namespace cserna {
+
+// Order in which BucketPriorityQueue returns items with equal keys.
+enum class BucketTieBreaking { LIFO, FIFO };
+
+// Bucket queue (Dial's algorithm) for non-negative integer keys that lie close together, e.g. f-values of unit cost
+// domains. Every key has its own bucket, so push, update and remove are O(1); pop moves a cursor over the empty
+// buckets towards the next non-empty one. Items with the same key are kept in a doubly linked list, which makes the
+// tie breaking order configurable without giving up O(1) removal.
+//
+// The buckets form a circular array indexed by the key modulo its size, which covers the keys from the smallest to the
+// largest queued key. It doubles when a key falls outside, so the memory and the cursor scans depend on the spread of
+// the keys (the maximum edge weight + 1 in Dijkstra's algorithm), not on how large they are.
+//
+// The index function stores the handle of the node of each item, i.e. its slot in the node pool.
+template <typename T,
+        typename IndexFunction,
+        typename KeyProjection,
+        BucketTieBreaking TIE_BREAKING = BucketTieBreaking::LIFO,
+        std::size_t INITIAL_CAPACITY = 0,
+        std::size_t MAX_CAPACITY = std::numeric_limits<std::size_t>::max(),
+        typename IndexType = typename detail::IndexTypeOf<IndexFunction, T>::type>
+class BucketPriorityQueue {
+public:
+    using Key = typename ProjectedKey<T, KeyProjection>::type;
+
+    static_assert(std::is_integral<Key>::value, "The key of a bucket queue must be an integer.");
+    static_assert(std::is_integral<IndexType>::value && std::is_unsigned<IndexType>::value,
+            "The index type must be an unsigned integer.");
+    static_assert(std::is_same<decltype(std::declval<IndexFunction&>()(std::declval<T&>())), IndexType&>::value,
+            "The index function must return a reference to IndexType.");
+
+    explicit BucketPriorityQueue(const KeyProjection& keyProjection = KeyProjection(),
+            IndexFunction indexFunction = IndexFunction())
+            : keyProjection{keyProjection}, indexFunction{std::move(indexFunction)}, nodes{}, freeNodes{}, buckets{} {
+        nodes.reserve(INITIAL_CAPACITY);
+        detail::reserveIndex(this->indexFunction, INITIAL_CAPACITY, 0);
+    }
+
+    ~BucketPriorityQueue() = default;
+    BucketPriorityQueue(const BucketPriorityQueue&) = delete;
+    BucketPriorityQueue(BucketPriorityQueue&&) noexcept = default;
+    BucketPriorityQueue& operator=(const BucketPriorityQueue&) = delete;
+    BucketPriorityQueue& operator=(BucketPriorityQueue&&) noexcept = default;
+
+    void push(T item) {
+        if (count == capacityLimit()) {
+            throw std::overflow_error("Priority queue reached its maximum capacity:" + std::to_string(capacityLimit()));
+        }
+
+        const Key key = keyOf(item);
+        const IndexType node = allocate(std::move(item));
+
+        cover(key);
+        link(node, key);
+        ++count;
+    }
+
+    T pop() {
+        if (count == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        const IndexType node = buckets[position(minimumKey)].head;
+        unlink(node);
+        --count;
+
+        return release(node);
+    }
+
+    T& top() {
+        if (count == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return nodes[buckets[position(minimumKey)].head].item;
+    }
+
+    const T& top() const {
+        if (count == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return nodes[buckets[position(minimumKey)].head].item;
+    }
+
+    // Key of the top item.
+    Key topKey() const {
+        if (count == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return minimumKey;
+    }
+
+    void remove(T item) {
+        if (!contains(item)) {
+            return;
+        }
+
+        const IndexType node = indexFunction(item);
+        unlink(node);
+        --count;
+
+        release(node);
+    }
+
+    void clear() {
+        for (auto& bucket : buckets) {
+            for (IndexType node = bucket.head; node != NIL; node = nodes[node].next) {
+                invalidateIndex(nodes[node].item);
+            }
+            bucket.head = NIL;
+            bucket.tail = NIL;
+        }
+
+        nodes.clear();
+        freeNodes.clear();
+        count = 0;
+    }
+
+    void insertOrUpdate(T item) {
+        if (indexFunction(item) == NIL) {
+            push(std::move(item));
+        } else {
+            update(std::move(item));
+        }
+    }
+
+    // Moves the item to the bucket of its current key.
+    void update(T item) {
+        const IndexType node = indexFunction(item);
+        assert(node != NIL && "Cannot update a node that is not in the queue!");
+
+        const Key key = keyOf(nodes[node].item);
+        if (key == nodes[node].key) {
+            return;
+        }
+
+        // The node is not counted while it moves, so the range of keys does not have to include its old key.
+        unlinkFrom(node);
+        --count;
+        cover(key);
+        link(node, key);
+        ++count;
+        advanceCursor();
+    }
+
+    template <typename Action>
+    void forEach(Action action = Action()) {
+        for (auto& bucket : buckets) {
+            for (IndexType node = bucket.head; node != NIL; node = nodes[node].next) {
+                action(nodes[node].item);
+            }
+        }
+    }
+
+    std::size_t size() const { return count; }
+
+    bool empty() const { return count == 0; }
+
+    bool contains(const T& item) const { return indexFunction(item) != NIL; }
+
+private:
+    static constexpr IndexType NIL = std::numeric_limits<IndexType>::max();
+
+    // Handles have to stay below the "not in queue" value of the index type.
+    static constexpr std::size_t capacityLimit() {
+        return MAX_CAPACITY < std::numeric_limits<IndexType>::max() ? MAX_CAPACITY
+                                                                    : std::numeric_limits<IndexType>::max();
+    }
+
+    struct Node {
+        explicit Node(T item) : item(std::move(item)) {}
+
+        T item;
+        IndexType previous = NIL;
+        IndexType next = NIL;
+        Key key = 0;
+    };
+
+    struct Bucket {
+        IndexType head = NIL;
+        IndexType tail = NIL;
+    };
+
+    void invalidateIndex(T& item) { detail::invalidateIndex(indexFunction, item, 0); }
+
+    Key keyOf(const T& item) const {
+        const Key key = keyProjection(item);
+        assert(!isNegative(key, std::is_signed<Key>()) && "Bucket queue keys must be non-negative.");
+
+        return key;
+    }
+
+    std::size_t position(const Key key) const { return static_cast<std::size_t>(key) & (buckets.size() - 1); }
+
+    // Widens the range of queued keys to include the key, growing the circular array if the range no longer fits.
+    void cover(const Key key) {
+        if (count == 0) {
+            if (buckets.empty()) {
+                buckets.resize(1);
+            }
+            minimumKey = key;
+            maximumKey = key;
+            return;
+        }
+
+        const Key low = key < minimumKey ? key : minimumKey;
+        const Key high = key > maximumKey ? key : maximumKey;
+        if (static_cast<std::size_t>(high - low) >= buckets.size()) {
+            grow(static_cast<std::size_t>(high - low) + 1);
+        }
+
+        minimumKey = low;
+        maximumKey = high;
+    }
+
+    // Every slot holds the items of a single key, so the lists move to their new slots as a whole.
+    void grow(const std::size_t range) {
+        std::size_t size = buckets.size() * 2;
+        while (size < range) {
+            size *= 2;
+        }
+
+        std::vector<Bucket> grown(size);
+        for (const Bucket& bucket : buckets) {
+            if (bucket.head != NIL) {
+                grown[static_cast<std::size_t>(nodes[bucket.head].key) & (size - 1)] = bucket;
+            }
+        }
+        buckets.swap(grown);
+    }
+
+    static bool isNegative(const Key key, std::true_type) { return key < 0; }
+
+    static bool isNegative(const Key, std::false_type) { return false; }
+
+    IndexType allocate(T item) {
+        IndexType node;
+        if (freeNodes.empty()) {
+            node = static_cast<IndexType>(nodes.size());
+            nodes.emplace_back(std::move(item));
+        } else {
+            node = freeNodes.back();
+            freeNodes.pop_back();
+            nodes[node].item = std::move(item);
+        }
+
+        indexFunction(nodes[node].item) = node;
+        return node;
+    }
+
+    T release(const IndexType node) {
+        T item(std::move(nodes[node].item));
+        invalidateIndex(item);
+        freeNodes.push_back(node);
+
+        return item;
+    }
+
+    // The key has to be covered.
+    void link(const IndexType node, const Key key) {
+        Bucket& bucket = buckets[position(key)];
+        Node& current = nodes[node];
+        current.key = key;
+
+        if (bucket.head == NIL) {
+            current.previous = NIL;
+            current.next = NIL;
+            bucket.head = node;
+            bucket.tail = node;
+        } else if (TIE_BREAKING == BucketTieBreaking::LIFO) {
+            current.previous = NIL;
+            current.next = bucket.head;
+            nodes[bucket.head].previous = node;
+            bucket.head = node;
+        } else {
+            current.previous = bucket.tail;
+            current.next = NIL;
+            nodes[bucket.tail].next = node;
+            bucket.tail = node;
+        }
+    }
+
+    void unlinkFrom(const IndexType node) {
+        Node& current = nodes[node];
+        Bucket& bucket = buckets[position(current.key)];
+
+        if (current.previous == NIL) {
+            bucket.head = current.next;
+        } else {
+            nodes[current.previous].next = current.next;
+        }
+
+        if (current.next == NIL) {
+            bucket.tail = current.previous;
+        } else {
+            nodes[current.next].previous = current.previous;
+        }
+
+        current.previous = NIL;
+        current.next = NIL;
+    }
+
+    // Unlinks the node and keeps the cursor on the first non-empty bucket.
+    void unlink(const IndexType node) {
+        unlinkFrom(node);
+
+        if (count > 1) {
+            advanceCursor();
+        }
+    }
+
+    void advanceCursor() {
+        while (buckets[position(minimumKey)].head == NIL) {
+            ++minimumKey;
+        }
+    }
+
+    KeyProjection keyProjection;
+    IndexFunction indexFunction;
+    std::vector<Node> nodes;
+    std::vector<IndexType> freeNodes;
+    // Circular array of a power of two size.
+    std::vector<Bucket> buckets;
+    // The cursor: the key of the first non-empty bucket if the queue is not empty.
+    Key minimumKey = 0;
+    // Not smaller than any queued key; only tightened when the queue runs empty.
+    Key maximumKey = 0;
+    std::size_t count = 0;
+};
+
+template <typename T,
+        typename IndexFunction,
+        typename KeyProjection,
+        BucketTieBreaking TIE_BREAKING,
+        std::size_t INITIAL_CAPACITY,
+        std::size_t MAX_CAPACITY,
+        typename IndexType>
+constexpr IndexType BucketPriorityQueue<T,
+        IndexFunction,
+        KeyProjection,
+        TIE_BREAKING,
+        INITIAL_CAPACITY,
+        MAX_CAPACITY,
+        IndexType>::NIL;
+
+} // namespace cserna
@@ -0,0 +1,440 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "dynamic_priority_queue.hpp"
+#include "spin_lock.hpp"
+
+namespace cserna {
+
+// Binary heap that can be used by several threads at once, after Hunt, Michael, Parthasarathy and Scott, "An
+// efficient algorithm for concurrent priority queue heaps" (1996). Every node has its own lock; a push sifts its item
+// up and a pop sifts the moved item down while holding only the locks of a parent and its children, so operations on
+// different parts of the heap run in parallel. Consecutive pushes take their slots in bit-reversed order within a
+// level, which sends them along different paths to the root.
+//
+// update() and remove() locate the item through the index function and briefly take the heap exclusively, as do
+// growth and clear(). The index function is called concurrently for different items, so it has to keep the index in
+// the item itself and declare so with `using is_intrusive = std::true_type;`. An item must not be pushed, updated or
+// removed by two threads at the same time.
+template <typename T,
+        typename IndexFunction,
+        typename ThreeWayComparator,
+        std::size_t INITIAL_CAPACITY = 0,
+        std::size_t MAX_CAPACITY = std::numeric_limits<std::size_t>::max(),
+        typename IndexType = typename detail::IndexTypeOf<IndexFunction, T>::type>
+class ConcurrentDynamicPriorityQueue {
+    static_assert(std::is_integral<IndexType>::value && std::is_unsigned<IndexType>::value,
+            "The index type must be an unsigned integer.");
+    static_assert(std::is_same<decltype(std::declval<IndexFunction&>()(std::declval<T&>())), IndexType&>::value,
+            "The index function must return a reference to IndexType.");
+    static_assert(detail::IsIntrusiveIndex<IndexFunction>::value,
+            "The index function must store the index in the items (is_intrusive) to be used concurrently.");
+
+public:
+    explicit ConcurrentDynamicPriorityQueue(const ThreeWayComparator& comparator = ThreeWayComparator(),
+            IndexFunction indexFunction = IndexFunction())
+            : comparator{comparator}, indexFunction{std::move(indexFunction)} {
+        std::size_t slots = 16;
+        while (slots - 1 < INITIAL_CAPACITY && slots - 1 < capacityLimit()) {
+            slots *= 2;
+        }
+        allocate(slots);
+    }
+
+    ~ConcurrentDynamicPriorityQueue() = default;
+    ConcurrentDynamicPriorityQueue(const ConcurrentDynamicPriorityQueue&) = delete;
+    ConcurrentDynamicPriorityQueue(ConcurrentDynamicPriorityQueue&&) = delete;
+    ConcurrentDynamicPriorityQueue& operator=(const ConcurrentDynamicPriorityQueue&) = delete;
+    ConcurrentDynamicPriorityQueue& operator=(ConcurrentDynamicPriorityQueue&&) = delete;
+
+    void push(T item) {
+        const std::size_t tag = nextTag.fetch_add(1, std::memory_order_relaxed);
+
+        structureLock.lock_shared();
+
+        heapLock.lock();
+        while (count == slotCount - 1 || count == capacityLimit()) {
+            const bool full = count == capacityLimit();
+            heapLock.unlock();
+            structureLock.unlock_shared();
+
+            if (full) {
+                throw std::overflow_error(
+                        "Priority queue reached its maximum capacity:" + std::to_string(capacityLimit()));
+            }
+
+            grow();
+            structureLock.lock_shared();
+            heapLock.lock();
+        }
+
+        std::size_t index = slotOf(++count);
+        nodes[index].lock.lock();
+        heapLock.unlock();
+
+        indexFunction(item) = static_cast<IndexType>(index - 1);
+        nodes[index].item = std::move(item);
+        nodes[index].tag = tag;
+        nodes[index].lock.unlock();
+
+        // Our item is found by its tag; a concurrent pop may have moved it further up.
+        while (index > 1) {
+            const std::size_t parentIndex = index / 2;
+            Node& parent = nodes[parentIndex];
+            Node& child = nodes[index];
+
+            parent.lock.lock();
+            child.lock.lock();
+
+            const std::size_t oldIndex = index;
+            if (parent.tag == AVAILABLE && child.tag == tag) {
+                if (comparator(child.item, parent.item) < 0) {
+                    swapNodes(parentIndex, index);
+                    index = parentIndex;
+                } else {
+                    child.tag = AVAILABLE;
+                    index = 0;
+                }
+            } else if (parent.tag == EMPTY) {
+                // The item was taken by a pop.
+                index = 0;
+            } else if (child.tag != tag) {
+                index = parentIndex;
+            }
+
+            child.lock.unlock();
+            nodes[oldIndex / 2].lock.unlock();
+        }
+
+        if (index == 1) {
+            nodes[1].lock.lock();
+            if (nodes[1].tag == tag) {
+                nodes[1].tag = AVAILABLE;
+            }
+            nodes[1].lock.unlock();
+        }
+
+        structureLock.unlock_shared();
+    }
+
+    T pop() {
+        T item;
+        if (!tryPop(item)) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return item;
+    }
+
+    // Moves the best item to the output and returns true, or returns false if the queue is empty.
+    bool tryPop(T& out) {
+        structureLock.lock_shared();
+
+        heapLock.lock();
+        if (count == 0) {
+            heapLock.unlock();
+            structureLock.unlock_shared();
+            return false;
+        }
+
+        const std::size_t bottom = slotOf(count--);
+        nodes[bottom].lock.lock();
+        heapLock.unlock();
+
+        T item(std::move(nodes[bottom].item));
+        nodes[bottom].tag = EMPTY;
+        nodes[bottom].lock.unlock();
+
+        Node& root = nodes[1];
+        root.lock.lock();
+        if (root.tag == EMPTY) {
+            // The bottom item was the root.
+            root.lock.unlock();
+            structureLock.unlock_shared();
+
+            invalidateIndex(item);
+            out = std::move(item);
+            return true;
+        }
+
+        using std::swap;
+        swap(item, root.item);
+        indexFunction(root.item) = 0;
+        root.tag = AVAILABLE;
+
+        siftDown();
+        structureLock.unlock_shared();
+
+        invalidateIndex(item);
+        out = std::move(item);
+        return true;
+    }
+
+    // Other threads compare the items while they sift, so the key of a queued item may only change inside update():
+    // change(item) is called while the heap is held exclusively, then the item is moved to its new place. Returns
+    // false without calling change if the item is not queued.
+    template <typename Change>
+    bool update(T item, Change change) {
+        structureLock.lock();
+
+        if (!isQueued(item)) {
+            structureLock.unlock();
+            return false;
+        }
+
+        const std::size_t index = static_cast<std::size_t>(indexFunction(item)) + 1;
+        change(nodes[index].item);
+
+        if (!siftUpExclusive(index)) {
+            siftDownExclusive(index);
+        }
+
+        structureLock.unlock();
+        return true;
+    }
+
+    // Returns false if the item is not queued.
+    bool remove(T item) {
+        structureLock.lock();
+
+        if (!isQueued(item)) {
+            structureLock.unlock();
+            return false;
+        }
+
+        const std::size_t index = static_cast<std::size_t>(indexFunction(item)) + 1;
+        const std::size_t bottom = slotOf(count--);
+
+        invalidateIndex(nodes[index].item);
+        if (index != bottom) {
+            nodes[index].item = std::move(nodes[bottom].item);
+            indexFunction(nodes[index].item) = static_cast<IndexType>(index - 1);
+        }
+        nodes[bottom].tag = EMPTY;
+
+        if (index != bottom && !siftUpExclusive(index)) {
+            siftDownExclusive(index);
+        }
+
+        structureLock.unlock();
+        return true;
+    }
+
+    void clear() {
+        structureLock.lock();
+
+        for (std::size_t counter = 1; counter <= count; ++counter) {
+            Node& node = nodes[slotOf(counter)];
+            invalidateIndex(node.item);
+            node.tag = EMPTY;
+        }
+        count = 0;
+
+        structureLock.unlock();
+    }
+
+    // Concurrent sifts rewrite the indices of the items they move, so this takes the heap exclusively as well.
+    bool contains(const T& item) {
+        structureLock.lock();
+        const bool result = isQueued(item);
+        structureLock.unlock();
+        return result;
+    }
+
+    // A snapshot that may be outdated as soon as it is returned.
+    std::size_t size() {
+        heapLock.lock();
+        const std::size_t currentCount = count;
+        heapLock.unlock();
+        return currentCount;
+    }
+
+    bool empty() { return size() == 0; }
+
+private:
+    static constexpr std::size_t EMPTY = 0;
+    static constexpr std::size_t AVAILABLE = 1;
+
+    // Positions have to stay below the "not in queue" value of the index type.
+    static constexpr std::size_t capacityLimit() {
+        return MAX_CAPACITY < std::numeric_limits<IndexType>::max() ? MAX_CAPACITY
+                                                                    : std::numeric_limits<IndexType>::max();
+    }
+
+    struct Node {
+        detail::SpinLock lock;
+        // EMPTY, AVAILABLE or the tag of the push that is still sifting this item up.
+        std::size_t tag = EMPTY;
+        T item{};
+    };
+
+    // Slot of the n-th item (1-based): the position within its level is bit-reversed.
+    static std::size_t slotOf(const std::size_t counter) {
+        std::size_t levelStart = 1;
+        std::size_t levelBits = 0;
+        while (levelStart <= counter / 2) {
+            levelStart *= 2;
+            ++levelBits;
+        }
+
+        std::size_t offset = counter - levelStart;
+        std::size_t reversed = 0;
+        for (std::size_t bit = 0; bit < levelBits; ++bit) {
+            reversed = (reversed << 1) | (offset & 1);
+            offset >>= 1;
+        }
+
+        return levelStart + reversed;
+    }
+
+    void invalidateIndex(T& item) { detail::invalidateIndex(indexFunction, item, 0); }
+
+    bool isQueued(const T& item) const { return indexFunction(item) != std::numeric_limits<IndexType>::max(); }
+
+    void allocate(const std::size_t slots) {
+        nodes.reset(new Node[slots]);
+        slotCount = slots;
+    }
+
+    // Doubles the node array, which holds complete levels only, while no other operation is running.
+    void grow() {
+        structureLock.lock();
+
+        if (count == slotCount - 1) {
+            std::unique_ptr<Node[]> oldNodes(std::move(nodes));
+            const std::size_t oldSlotCount = slotCount;
+            allocate(slotCount * 2);
+
+            for (std::size_t index = 1; index < oldSlotCount; ++index) {
+                nodes[index].item = std::move(oldNodes[index].item);
+                nodes[index].tag = oldNodes[index].tag;
+            }
+        }
+
+        structureLock.unlock();
+    }
+
+    void swapNodes(const std::size_t lhs, const std::size_t rhs) {
+        using std::swap;
+        swap(nodes[lhs].item, nodes[rhs].item);
+        swap(nodes[lhs].tag, nodes[rhs].tag);
+        indexFunction(nodes[lhs].item) = static_cast<IndexType>(lhs - 1);
+        indexFunction(nodes[rhs].item) = static_cast<IndexType>(rhs - 1);
+    }
+
+    // Hand-over-hand sift down from the root, which is locked by the caller.
+    void siftDown() {
+        std::size_t index = 1;
+
+        while (index * 2 + 1 < slotCount) {
+            const std::size_t left = index * 2;
+            const std::size_t right = left + 1;
+
+            nodes[left].lock.lock();
+            nodes[right].lock.lock();
+
+            std::size_t child;
+            if (nodes[left].tag == EMPTY) {
+                nodes[right].lock.unlock();
+                nodes[left].lock.unlock();
+                break;
+            } else if (nodes[right].tag == EMPTY || comparator(nodes[left].item, nodes[right].item) < 0) {
+                nodes[right].lock.unlock();
+                child = left;
+            } else {
+                nodes[left].lock.unlock();
+                child = right;
+            }
+
+            if (comparator(nodes[child].item, nodes[index].item) < 0) {
+                swapNodes(child, index);
+                nodes[index].lock.unlock();
+                index = child;
+            } else {
+                nodes[child].lock.unlock();
+                break;
+            }
+        }
+
+        nodes[index].lock.unlock();
+    }
+
+    // Sequential sift operations for update() and remove(), which hold the structure lock exclusively.
+    bool siftUpExclusive(std::size_t index) {
+        const std::size_t originalIndex = index;
+
+        while (index > 1 && comparator(nodes[index].item, nodes[index / 2].item) < 0) {
+            swapNodes(index, index / 2);
+            index /= 2;
+        }
+
+        return index != originalIndex;
+    }
+
+    void siftDownExclusive(std::size_t index) {
+        while (index * 2 < slotCount) {
+            std::size_t child = index * 2;
+            if (nodes[child].tag == EMPTY) {
+                return;
+            }
+            if (child + 1 < slotCount && nodes[child + 1].tag != EMPTY &&
+                    comparator(nodes[child + 1].item, nodes[child].item) < 0) {
+                ++child;
+            }
+
+            if (comparator(nodes[child].item, nodes[index].item) >= 0) {
+                return;
+            }
+
+            swapNodes(child, index);
+            index = child;
+        }
+    }
+
+    ThreeWayComparator comparator;
+    IndexFunction indexFunction;
+    std::unique_ptr<Node[]> nodes;
+    std::size_t slotCount = 0;
+    // Number of items, protected by heapLock.
+    std::size_t count = 0;
+    detail::SpinLock heapLock;
+    // Shared by push and pop, exclusive for update, remove, clear and growth.
+    detail::SharedSpinLock structureLock;
+    std::atomic<std::size_t> nextTag{2};
+};
+
+template <typename T,
+        typename IndexFunction,
+        typename ThreeWayComparator,
+        std::size_t INITIAL_CAPACITY,
+        std::size_t MAX_CAPACITY,
+        typename IndexType>
+constexpr std::size_t ConcurrentDynamicPriorityQueue<T,
+        IndexFunction,
+        ThreeWayComparator,
+        INITIAL_CAPACITY,
+        MAX_CAPACITY,
+        IndexType>::EMPTY;
+
+template <typename T,
+        typename IndexFunction,
+        typename ThreeWayComparator,
+        std::size_t INITIAL_CAPACITY,
+        std::size_t MAX_CAPACITY,
+        typename IndexType>
+constexpr std::size_t ConcurrentDynamicPriorityQueue<T,
+        IndexFunction,
+        ThreeWayComparator,
+        INITIAL_CAPACITY,
+        MAX_CAPACITY,
+        IndexType>::AVAILABLE;
+
+} // namespace cserna
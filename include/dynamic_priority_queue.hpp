@@ -1,42 +1,86 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <functional>
+#include <iterator>
 #include <limits>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "fixed_capacity_vector.hpp"
+
 namespace cserna {
 
-template <typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<T>>
+template <typename T,
+        typename Hash = std::hash<T>,
+        typename Equal = std::equal_to<T>,
+        typename IndexType = std::size_t>
 class NonIntrusiveIndexFunction {
 public:
-    std::size_t& operator()(T& item) {
+    IndexType& operator()(T& item) {
         const auto itemIterator = indexMap.find(item);
 
         if (itemIterator == indexMap.cend()) {
-            std::size_t& index = indexMap[item];
-            index = std::numeric_limits<std::size_t>::max();
+            IndexType& index = indexMap[item];
+            index = std::numeric_limits<IndexType>::max();
             return index;
         } else {
             return itemIterator->second;
         }
     }
 
-    std::size_t operator()(const T& item) const {
+    IndexType operator()(const T& item) const {
         const auto itemIterator = indexMap.find(item);
         if (itemIterator == indexMap.cend()) {
-            return std::numeric_limits<std::size_t>::max();
+            return std::numeric_limits<IndexType>::max();
         } else {
             return itemIterator->second;
         }
     }
 
 private:
-    std::unordered_map<T, std::size_t, Hash, Equal> indexMap;
+    std::unordered_map<T, IndexType, Hash, Equal> indexMap;
+};
+
+// Index function for items that carry a dense integer id. The positions are stored in a vector indexed by the id,
+// which grows automatically when a larger id shows up.
+template <typename T, typename IdProjection, typename IndexType = std::size_t>
+class DenseIdIndexFunction {
+public:
+    explicit DenseIdIndexFunction(const IdProjection& idProjection = IdProjection())
+            : idProjection{idProjection}, indices{} {}
+
+    IndexType& operator()(T& item) {
+        const auto id = static_cast<std::size_t>(idProjection(item));
+
+        if (id >= indices.size()) {
+            indices.resize(id + 1, std::numeric_limits<IndexType>::max());
+        }
+
+        return indices[id];
+    }
+
+    IndexType operator()(const T& item) const {
+        const auto id = static_cast<std::size_t>(idProjection(item));
+
+        if (id >= indices.size()) {
+            return std::numeric_limits<IndexType>::max();
+        } else {
+            return indices[id];
+        }
+    }
+
+    void reserve(const std::size_t count) { indices.reserve(count); }
+
+private:
+    IdProjection idProjection;
+    std::vector<IndexType> indices;
 };
 
 template <typename T, typename Comparator = std::less<T>>
@@ -54,32 +98,129 @@ private:
     const Comparator comparator;
 };
 
+namespace detail {
+
+// The index type of an index function is the type it returns for const items. The "not in queue" sentinel is the
+// largest value of this type.
+template <typename IndexFunction, typename T>
+struct IndexTypeOf {
+    using type = typename std::decay<decltype(std::declval<const IndexFunction&>()(std::declval<const T&>()))>::type;
+};
+
+// Index functions may provide erase(item), which is called instead of writing the "not in queue" index when an item
+// leaves the queue, and reserve(count), which is called with the initial capacity of the queue.
+template <typename IndexFunction, typename T>
+auto invalidateIndex(IndexFunction& indexFunction, T& item, int) -> decltype(indexFunction.erase(item), void()) {
+    indexFunction.erase(item);
+}
+
+template <typename IndexFunction, typename T>
+void invalidateIndex(IndexFunction& indexFunction, T& item, long) {
+    indexFunction(item) = std::numeric_limits<typename IndexTypeOf<IndexFunction, T>::type>::max();
+}
+
+template <typename IndexFunction>
+auto reserveIndex(IndexFunction& indexFunction, std::size_t count, int)
+        -> decltype(indexFunction.reserve(count), void()) {
+    indexFunction.reserve(count);
+}
+
+template <typename IndexFunction>
+void reserveIndex(IndexFunction&, std::size_t, long) {}
+
+// Index functions that keep the index in the items can declare `using is_intrusive = std::true_type;`. Two queues then
+// share the indices of their items, so merge() can leave the items of the larger queue untouched.
+template <typename>
+struct VoidType {
+    using type = void;
+};
+
+template <typename IndexFunction, typename = void>
+struct IsIntrusiveIndex : std::false_type {};
+
+template <typename IndexFunction>
+struct IsIntrusiveIndex<IndexFunction, typename VoidType<typename IndexFunction::is_intrusive>::type>
+        : IndexFunction::is_intrusive {};
+
+// std::min is not constexpr in C++11.
+constexpr std::size_t smallerCapacity(const std::size_t lhs, const std::size_t rhs) {
+    return lhs < rhs ? lhs : rhs;
+}
+
+// Number of items a storage type of the queue can hold; only fixed-capacity storage is limited.
+template <typename Storage>
+struct StorageCapacity {
+    static constexpr std::size_t value = std::numeric_limits<std::size_t>::max();
+};
+
+template <typename T, std::size_t CAPACITY>
+struct StorageCapacity<FixedCapacityVector<T, CAPACITY>> {
+    static constexpr std::size_t value = CAPACITY;
+};
+
+// Only a std::vector can change hands between two queues; other storage is tied to its queue, e.g. by a backing file.
+template <typename Storage>
+struct IsStdVector : std::false_type {};
+
+template <typename T, typename Allocator>
+struct IsStdVector<std::vector<T, Allocator>> : std::true_type {};
+
+} // namespace detail
+
 template <typename T,
         typename IndexFunction,
         typename ThreeWayComparator,
         std::size_t INITIAL_CAPACITY = 0,
-        std::size_t MAX_CAPACITY = std::numeric_limits<std::size_t>::max()>
+        std::size_t MAX_CAPACITY = std::numeric_limits<std::size_t>::max(),
+        std::size_t ARITY = 2,
+        bool BOTTOM_UP_POP = false,
+        typename IndexType = typename detail::IndexTypeOf<IndexFunction, T>::type,
+        typename Storage = std::vector<T>>
 class DynamicPriorityQueue {
+    static_assert(ARITY >= 2, "The heap arity must be at least two.");
+    static_assert(std::is_integral<IndexType>::value && std::is_unsigned<IndexType>::value,
+            "The index type must be an unsigned integer.");
+    static_assert(std::is_same<decltype(std::declval<IndexFunction&>()(std::declval<T&>())), IndexType&>::value,
+            "The index function must return a reference to IndexType.");
+    static_assert(std::is_same<typename Storage::value_type, T>::value, "The storage must hold items of type T.");
+
 public:
+    // Passing a storage instance allows e.g. a std::vector with a stateful allocator. A non-empty storage has to hold a
+    // heap built by a queue of the same type, e.g. a reopened MappedFileVector; call reindex() if the index function
+    // does not already know the positions of its items.
     explicit DynamicPriorityQueue(const ThreeWayComparator& comparator = ThreeWayComparator(),
-            IndexFunction indexFunction = IndexFunction())
-            : comparator{comparator}, indexFunction{std::move(indexFunction)}, queue{} {
+            IndexFunction indexFunction = IndexFunction(),
+            Storage storage = Storage())
+            : comparator{comparator}, indexFunction{std::move(indexFunction)}, queue{std::move(storage)} {
+        queue.reserve(INITIAL_CAPACITY);
+        detail::reserveIndex(this->indexFunction, INITIAL_CAPACITY, 0);
+    }
+
+    template <typename ForwardIterator>
+    DynamicPriorityQueue(ForwardIterator first,
+            ForwardIterator last,
+            const ThreeWayComparator& comparator = ThreeWayComparator(),
+            IndexFunction indexFunction = IndexFunction(),
+            Storage storage = Storage())
+            : comparator{comparator}, indexFunction{std::move(indexFunction)}, queue{std::move(storage)} {
         queue.reserve(INITIAL_CAPACITY);
+        detail::reserveIndex(this->indexFunction, INITIAL_CAPACITY, 0);
+        pushBulk(first, last);
     }
-    
+
     ~DynamicPriorityQueue() = default;
     DynamicPriorityQueue(const DynamicPriorityQueue&) = delete;
     DynamicPriorityQueue(DynamicPriorityQueue&&) noexcept = default;
     DynamicPriorityQueue& operator=(const DynamicPriorityQueue&) = delete;
-    DynamicPriorityQueue& operator=(DynamicPriorityQueue&&) noexcept = default
+    DynamicPriorityQueue& operator=(DynamicPriorityQueue&&) noexcept = default;
 
     void push(T item) {
-        if (queue.size() == MAX_CAPACITY) {
-            throw std::overflow_error("Priority queue reached its maximum capacity:" + std::to_string(MAX_CAPACITY));
+        if (queue.size() == capacityLimit()) {
+            throw std::overflow_error("Priority queue reached its maximum capacity:" + std::to_string(capacityLimit()));
         }
 
         const std::size_t index = queue.size();
-        indexFunction(item) = index;
+        indexFunction(item) = static_cast<IndexType>(index);
         queue.push_back(std::move(item));
 
         if (index != 0) {
@@ -87,6 +228,65 @@ public:
         }
     }
 
+    // Appends all items of the range and restores the heap property. Large batches are heapified in linear time and
+    // the index of every item is written once at the end; small batches are sifted up one by one.
+    template <typename ForwardIterator>
+    void pushBulk(ForwardIterator first, ForwardIterator last) {
+        const std::size_t count = static_cast<std::size_t>(std::distance(first, last));
+        const std::size_t originalSize = queue.size();
+
+        if (count > capacityLimit() - originalSize) {
+            throw std::overflow_error("Priority queue reached its maximum capacity:" + std::to_string(capacityLimit()));
+        }
+
+        queue.reserve(originalSize + count);
+        for (; first != last; ++first) {
+            queue.push_back(*first);
+        }
+
+        restoreAppended(originalSize);
+    }
+
+    // Moves all items of the other queue into this one in O(n + m). With std::vector storage the vector of the larger
+    // queue is kept and the items of the smaller one are appended; any other storage stays with its queue, so the items
+    // of the other queue are always appended to this one's. Then the heap is rebuilt or the appended items are sifted
+    // up, whichever is cheaper. The other queue is left empty; its index function is told that the items left, as by
+    // clear().
+    void merge(DynamicPriorityQueue&& other) {
+        if (other.queue.size() > capacityLimit() - queue.size()) {
+            throw std::overflow_error("Priority queue reached its maximum capacity:" + std::to_string(capacityLimit()));
+        }
+
+        const bool intrusive = detail::IsIntrusiveIndex<IndexFunction>::value;
+
+        if (detail::IsStdVector<Storage>::value && queue.size() < other.queue.size()) {
+            queue.swap(other.queue);
+
+            // The items of the other queue keep their positions, which this queue's index function has to learn
+            // unless the positions are stored in the items.
+            if (!intrusive) {
+                for (std::size_t index = 0; index < queue.size(); ++index) {
+                    detail::invalidateIndex(other.indexFunction, queue[index], 0);
+                    indexFunction(queue[index]) = static_cast<IndexType>(index);
+                }
+            }
+        } else if (!intrusive) {
+            for (auto& item : other.queue) {
+                detail::invalidateIndex(other.indexFunction, item, 0);
+            }
+        }
+
+        const std::size_t originalSize = queue.size();
+        queue.reserve(originalSize + other.queue.size());
+        for (auto& item : other.queue) {
+            queue.push_back(std::move(item));
+        }
+
+        other.queue.clear();
+
+        restoreAppended(originalSize);
+    }
+
     T pop() {
         if (queue.size() == 0) {
             throw std::underflow_error("Priority queue is empty.");
@@ -98,7 +298,7 @@ public:
             "Internal index of top item was "
             "non-zero");
 
-        indexFunction(top_item) = std::numeric_limits<std::size_t>::max();
+        invalidateIndex(top_item);
 
         if (queue.size() == 1) {
             queue.pop_back();
@@ -109,12 +309,53 @@ public:
             indexFunction(last_item) = 0;
             queue[0] = std::move(last_item);
             queue.pop_back();
-            siftDown(0);
+
+            if (BOTTOM_UP_POP) {
+                siftDownBottomUp(0);
+            } else {
+                siftDown(0);
+            }
 
             return top_item;
         }
     }
 
+    // Equivalent to pop() followed by push(item), but the new item is placed at the root and sifted down only once.
+    T replaceTop(T item) {
+        if (queue.size() == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        T top_item(std::move(queue[0]));
+
+        assert(indexFunction(top_item) == 0 &&
+                "Internal index of top item was "
+                "non-zero");
+
+        invalidateIndex(top_item);
+
+        indexFunction(item) = 0;
+        queue[0] = std::move(item);
+
+        if (BOTTOM_UP_POP) {
+            siftDownBottomUp(0);
+        } else {
+            siftDown(0);
+        }
+
+        return top_item;
+    }
+
+    // Equivalent to push(item) followed by pop(). If the item is not worse than the top it is returned right away
+    // without ever entering the queue, so its index is left as it was.
+    T pushPop(T item) {
+        if (queue.size() == 0 || comparator(item, queue[0]) <= 0) {
+            return item;
+        }
+
+        return replaceTop(std::move(item));
+    }
+
     T& top() {
         if (queue.size() == 0) {
             throw std::underflow_error("Priority queue is empty.");
@@ -138,7 +379,7 @@ public:
 
         const std::size_t index = indexFunction(item);
         // Invalidate the item's index.
-        indexFunction(item) = std::numeric_limits<std::size_t>::max();
+        invalidateIndex(item);
 
         if (index == queue.size() - 1) {
             queue.pop_back();
@@ -147,23 +388,26 @@ public:
 
         // Override the removed item's slot with the last item
         queue[index] = std::move(queue[queue.size() - 1]);
-        indexFunction(queue[index]) = index;
+        indexFunction(queue[index]) = static_cast<IndexType>(index);
 
         queue.pop_back();
 
-        // The heap property might've been violated by the swap. Let's fix it.
-        siftDown(index);
+        // The heap property might've been violated by the swap. Let's fix it. The last item can be better than the
+        // parent of the removed slot, in which case it has to move up instead of down.
+        if (!siftUp(index)) {
+            siftDown(index);
+        }
     }
 
     void clear() {
         for (std::size_t i = 0; i < queue.size(); i++) {
-            indexFunction(queue[i]) = std::numeric_limits<std::size_t>::max();
+            invalidateIndex(queue[i]);
         }
         queue.clear();
     }
 
     void insertOrUpdate(T item) {
-        if (indexFunction(item) == std::numeric_limits<std::size_t>::max()) {
+        if (indexFunction(item) == std::numeric_limits<IndexType>::max()) {
             // Item is not in the queue yet
             push(std::move(item));
         } else {
@@ -174,16 +418,81 @@ public:
 
     void update(T item) {
         const std::size_t originalIndex = indexFunction(item);
-        assert(originalIndex != std::numeric_limits<std::size_t>::max() &&
+        assert(originalIndex != std::numeric_limits<IndexType>::max() &&
                 "Cannot update a node that is not in the queue!");
 
-        const bool moved = siftUp(originalIndex);
+        if (!siftUp(originalIndex)) {
+            siftDown(originalIndex);
+        }
+    }
+
+    // Calls change on the queued copy of the item, then moves it to its new place. Needed when the queue holds the
+    // items by value, where changing the caller's copy has no effect on the queue.
+    template <typename Change>
+    void update(const T& item, Change change) {
+        const std::size_t originalIndex = indexFunction(item);
+        assert(originalIndex != std::numeric_limits<IndexType>::max() &&
+                "Cannot update a node that is not in the queue!");
 
-        if (!moved) {
+        change(queue[originalIndex]);
+        if (!siftUp(originalIndex)) {
             siftDown(originalIndex);
         }
     }
 
+    // Same as insertOrUpdate, but an item that is already in the queue is assumed to have improved (see decreaseKey).
+    void insertOrDecrease(T item) {
+        if (indexFunction(item) == std::numeric_limits<IndexType>::max()) {
+            push(std::move(item));
+        } else {
+            decreaseKey(std::move(item));
+        }
+    }
+
+    // Restores the heap property after the item got better (compares less than before); the item can only move up.
+    void decreaseKey(T item) {
+        const std::size_t originalIndex = indexFunction(item);
+        assert(originalIndex != std::numeric_limits<IndexType>::max() &&
+                "Cannot update a node that is not in the queue!");
+
+        siftUp(originalIndex);
+    }
+
+    // Restores the heap property after the item got worse (compares greater than before); the item can only move down.
+    void increaseKey(T item) {
+        const std::size_t originalIndex = indexFunction(item);
+        assert(originalIndex != std::numeric_limits<IndexType>::max() &&
+                "Cannot update a node that is not in the queue!");
+
+        siftDown(originalIndex);
+    }
+
+    // Restores the heap property after the priority of every item in the range changed. If the range covers more
+    // than the rebuild ratio of the queue the whole heap is rebuilt in linear time instead of sifting each item.
+    template <typename ForwardIterator>
+    void updateBatch(ForwardIterator first, ForwardIterator last) {
+        const auto count = static_cast<std::size_t>(std::distance(first, last));
+
+        if (static_cast<double>(count) > rebuildRatio * static_cast<double>(queue.size())) {
+#ifndef NDEBUG
+            for (ForwardIterator it = first; it != last; ++it) {
+                assert(contains(*it) && "Cannot update a node that is not in the queue!");
+            }
+#endif
+            heapify();
+            return;
+        }
+
+        for (; first != last; ++first) {
+            update(*first);
+        }
+    }
+
+    // Fraction of the queue size above which updateBatch rebuilds the heap.
+    void setRebuildRatio(const double ratio) { rebuildRatio = ratio; }
+
+    double getRebuildRatio() const { return rebuildRatio; }
+
     template <typename Action>
     void forEach(Action action = Action()) {
         for (auto& item : queue) {
@@ -191,19 +500,101 @@ public:
         }
     }
 
+    // Copies the best k items (fewer if the queue is smaller) in order to the output without modifying the queue. The
+    // heap is explored from the root with a small frontier heap of positions, so this costs O(k log k).
+    template <typename OutputIterator>
+    OutputIterator topK(const std::size_t k, OutputIterator out) const {
+        for (const std::size_t index : bestPositions(k)) {
+            *out = queue[index];
+            ++out;
+        }
+
+        return out;
+    }
+
+    // Removes the best k items (fewer if the queue is smaller) and moves them in order to the output. Large batches
+    // are taken out of the heap array at once and the rest is rebuilt in O(n) with a single index write per item,
+    // instead of sifting from the root k times.
+    template <typename OutputIterator>
+    OutputIterator popBatch(std::size_t k, OutputIterator out) {
+        if (k > queue.size()) {
+            k = queue.size();
+        }
+
+        if (k * depth() <= queue.size()) {
+            for (std::size_t i = 0; i < k; ++i) {
+                *out = pop();
+                ++out;
+            }
+
+            return out;
+        }
+
+        std::vector<bool> taken(queue.size(), false);
+        for (const std::size_t index : bestPositions(k)) {
+            invalidateIndex(queue[index]);
+            *out = std::move(queue[index]);
+            ++out;
+            taken[index] = true;
+        }
+
+        std::size_t remaining = 0;
+        for (std::size_t index = 0; index < queue.size(); ++index) {
+            if (!taken[index]) {
+                if (index != remaining) {
+                    queue[remaining] = std::move(queue[index]);
+                }
+                ++remaining;
+            }
+        }
+
+        queue.erase(queue.begin() + static_cast<std::ptrdiff_t>(remaining), queue.end());
+        heapify();
+
+        return out;
+    }
+
+    // Writes the position of every item to the index function in O(n), e.g. after adopting a storage that already
+    // holds a heap.
+    void reindex() {
+        for (std::size_t index = 0; index < queue.size(); ++index) {
+            indexFunction(queue[index]) = static_cast<IndexType>(index);
+        }
+    }
+
+    // Sorted copy of all items. The queue and the index function are not touched.
+    std::vector<T> orderedSnapshot() const {
+        std::vector<T> snapshot(queue.begin(), queue.end());
+        std::sort(snapshot.begin(), snapshot.end(), [this](const T& lhs, const T& rhs) {
+            return comparator(lhs, rhs) < 0;
+        });
+
+        return snapshot;
+    }
+
     std::size_t size() const { return queue.size(); }
 
     bool empty() const { return queue.size() == 0; }
 
-    bool contains(const T& item) const { return indexFunction(item) != std::numeric_limits<std::size_t>::max(); }
+    bool contains(const T& item) const { return indexFunction(item) != std::numeric_limits<IndexType>::max(); }
 
 private:
+    // Positions have to stay below the "not in queue" value of the index type and fit into fixed-capacity storage.
+    static constexpr std::size_t capacityLimit() {
+        return detail::smallerCapacity(
+                detail::smallerCapacity(MAX_CAPACITY, std::numeric_limits<IndexType>::max()),
+                detail::StorageCapacity<Storage>::value);
+    }
+
+    void invalidateIndex(T& item) { detail::invalidateIndex(indexFunction, item, 0); }
+
+    // Returns true if the item was moved.
     bool siftUp(const std::size_t index) {
         T item = std::move(queue[index]);
         std::size_t currentIndex = index;
 
         while (currentIndex > 0) {
-            const std::size_t parentIndex = (currentIndex - 1) / 2;
+            const std::size_t parentIndex = (currentIndex - 1) / ARITY;
             T& parentItem = queue[parentIndex];
 
             if (comparator(item, parentItem) >= 0) {
@@ -211,51 +602,198 @@ private:
             }
 
             // Move parent down and update its index
-            indexFunction(parentItem) = currentIndex;
+            indexFunction(parentItem) = static_cast<IndexType>(currentIndex);
             queue[currentIndex] = std::move(queue[parentIndex]);
             currentIndex = parentIndex;
         }
 
-        indexFunction(item) = currentIndex;
+        indexFunction(item) = static_cast<IndexType>(currentIndex);
         queue[currentIndex] = std::move(item);
 
-        return currentIndex == index;
+        return currentIndex != index;
+    }
+
+    // Number of levels of the heap.
+    std::size_t depth() const {
+        std::size_t levels = 0;
+        for (std::size_t levelSize = queue.size(); levelSize > 0; levelSize /= ARITY) {
+            ++levels;
+        }
+        return levels;
     }
 
+    // Positions of the best k items in order, found by exploring the heap from the root with a frontier heap.
+    std::vector<std::size_t> bestPositions(const std::size_t k) const {
+        const auto frontierCompare = [this](std::size_t lhs, std::size_t rhs) {
+            return comparator(queue[lhs], queue[rhs]) > 0;
+        };
+
+        std::vector<std::size_t> positions;
+        std::vector<std::size_t> frontier;
+        if (!queue.empty() && k > 0) {
+            frontier.push_back(0);
+        }
+
+        while (positions.size() < k && !frontier.empty()) {
+            std::pop_heap(frontier.begin(), frontier.end(), frontierCompare);
+            const std::size_t index = frontier.back();
+            frontier.pop_back();
+
+            positions.push_back(index);
+
+            const std::size_t firstChildIndex = index * ARITY + 1;
+            for (std::size_t childIndex = firstChildIndex;
+                    childIndex < firstChildIndex + ARITY && childIndex < queue.size();
+                    ++childIndex) {
+                frontier.push_back(childIndex);
+                std::push_heap(frontier.begin(), frontier.end(), frontierCompare);
+            }
+        }
+
+        return positions;
+    }
+
+    // Restores the heap property after items were appended from the given index on. Sifting up costs
+    // O(count * log(size)) while heapify costs O(size).
+    void restoreAppended(const std::size_t originalSize) {
+        const std::size_t count = queue.size() - originalSize;
+
+        if (count * depth() < queue.size()) {
+            for (std::size_t index = originalSize; index < queue.size(); ++index) {
+                siftUp(index);
+            }
+        } else {
+            heapify();
+        }
+    }
+
+    // Floyd's bottom-up heap construction. Items are sifted without touching their indices, which are assigned in a
+    // single pass after the heap is built.
+    void heapify() {
+        const std::size_t size = queue.size();
+
+        if (size > 1) {
+            for (std::size_t index = (size - 2) / ARITY + 1; index > 0; --index) {
+                siftDown<false>(index - 1);
+            }
+        }
+
+        for (std::size_t index = 0; index < size; ++index) {
+            indexFunction(queue[index]) = static_cast<IndexType>(index);
+        }
+    }
+
+    // Returns true if the item was moved.
+    template <bool UPDATE_INDEX = true>
     bool siftDown(const std::size_t index) {
         T item = std::move(queue[index]);
 
         std::size_t currentIndex = index;
-        const std::size_t half = queue.size() / 2;
+        const std::size_t size = queue.size();
 
-        while (currentIndex < half) {
-            std::size_t leftChildIndex = currentIndex * 2 + 1;
-            std::size_t rightChildIndex = currentIndex * 2 + 2;
+        while (true) {
+            // Children of node i are stored at [i * ARITY + 1, i * ARITY + ARITY]
+            const std::size_t firstChildIndex = currentIndex * ARITY + 1;
+            if (firstChildIndex >= size) {
+                break;
+            }
 
-            std::size_t betterChildIndex = leftChildIndex;
+            const std::size_t lastChildIndex = firstChildIndex + ARITY < size ? firstChildIndex + ARITY : size;
+            std::size_t betterChildIndex = firstChildIndex;
 
-            if (rightChildIndex < queue.size() && comparator(queue[leftChildIndex], queue[rightChildIndex]) > 0) {
-                betterChildIndex = rightChildIndex;
+            for (std::size_t childIndex = firstChildIndex + 1; childIndex < lastChildIndex; ++childIndex) {
+                if (comparator(queue[betterChildIndex], queue[childIndex]) > 0) {
+                    betterChildIndex = childIndex;
+                }
             }
 
             if (comparator(item, queue[betterChildIndex]) <= 0) {
                 break;
             }
 
-            indexFunction(queue[betterChildIndex]) = currentIndex;
+            if (UPDATE_INDEX) {
+                indexFunction(queue[betterChildIndex]) = static_cast<IndexType>(currentIndex);
+            }
             queue[currentIndex] = std::move(queue[betterChildIndex]);
             currentIndex = betterChildIndex;
         }
 
-        indexFunction(item) = currentIndex;
+        if (UPDATE_INDEX) {
+            indexFunction(item) = static_cast<IndexType>(currentIndex);
+        }
         queue[currentIndex] = std::move(item);
 
-        return currentIndex == index;
+        return currentIndex != index;
+    }
+
+    // Bottom-up (Floyd/Wegener) variant of siftDown: first walks the hole down to a leaf along the better children,
+    // comparing only siblings, then sifts the item up from there. Items reinserted at the root almost always belong
+    // close to the leaves, so this saves roughly one comparison per level compared to siftDown.
+    void siftDownBottomUp(const std::size_t index) {
+        T item = std::move(queue[index]);
+
+        std::size_t holeIndex = index;
+        const std::size_t size = queue.size();
+
+        while (true) {
+            const std::size_t firstChildIndex = holeIndex * ARITY + 1;
+            if (firstChildIndex >= size) {
+                break;
+            }
+
+            const std::size_t lastChildIndex = firstChildIndex + ARITY < size ? firstChildIndex + ARITY : size;
+            std::size_t betterChildIndex = firstChildIndex;
+
+            for (std::size_t childIndex = firstChildIndex + 1; childIndex < lastChildIndex; ++childIndex) {
+                if (comparator(queue[betterChildIndex], queue[childIndex]) > 0) {
+                    betterChildIndex = childIndex;
+                }
+            }
+
+            indexFunction(queue[betterChildIndex]) = static_cast<IndexType>(holeIndex);
+            queue[holeIndex] = std::move(queue[betterChildIndex]);
+            holeIndex = betterChildIndex;
+        }
+
+        while (holeIndex > index) {
+            const std::size_t parentIndex = (holeIndex - 1) / ARITY;
+            T& parentItem = queue[parentIndex];
+
+            if (comparator(item, parentItem) >= 0) {
+                break;
+            }
+
+            indexFunction(parentItem) = static_cast<IndexType>(holeIndex);
+            queue[holeIndex] = std::move(queue[parentIndex]);
+            holeIndex = parentIndex;
+        }
+
+        indexFunction(item) = static_cast<IndexType>(holeIndex);
+        queue[holeIndex] = std::move(item);
     }
 
-    const ThreeWayComparator& comparator;
+    ThreeWayComparator comparator;
     IndexFunction indexFunction;
-    std::vector<T> queue;
+    Storage queue;
+    double rebuildRatio = 0.1;
 };
 
+// Queue whose items live in an inline buffer of CAPACITY items: it never allocates, and pushing into a full queue
+// throws std::overflow_error.
+template <typename T,
+        typename IndexFunction,
+        typename ThreeWayComparator,
+        std::size_t CAPACITY,
+        std::size_t ARITY = 2,
+        bool BOTTOM_UP_POP = false>
+using FixedCapacityDynamicPriorityQueue = DynamicPriorityQueue<T,
+        IndexFunction,
+        ThreeWayComparator,
+        CAPACITY,
+        CAPACITY,
+        ARITY,
+        BOTTOM_UP_POP,
+        typename detail::IndexTypeOf<IndexFunction, T>::type,
+        FixedCapacityVector<T, CAPACITY>>;
+
 } // namespace cserna
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cserna {
+
+// Vector-like container with an inline buffer of CAPACITY items. It never allocates and never grows, so it can be
+// used as the storage of a priority queue whose maximum size is known at compile time (see
+// FixedCapacityDynamicPriorityQueue). Pushing beyond the capacity is undefined; the queue checks its capacity limit
+// before every push.
+template <typename T, std::size_t CAPACITY>
+class FixedCapacityVector {
+    static_assert(CAPACITY > 0, "The capacity must be positive.");
+    static_assert(std::is_nothrow_move_constructible<T>::value, "Items must be nothrow move constructible.");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    FixedCapacityVector() = default;
+
+    FixedCapacityVector(const FixedCapacityVector& other) {
+        for (const T& item : other) {
+            push_back(item);
+        }
+    }
+
+    FixedCapacityVector(FixedCapacityVector&& other) noexcept {
+        for (T& item : other) {
+            push_back(std::move(item));
+        }
+        other.clear();
+    }
+
+    FixedCapacityVector& operator=(const FixedCapacityVector& other) {
+        if (this != &other) {
+            clear();
+            for (const T& item : other) {
+                push_back(item);
+            }
+        }
+        return *this;
+    }
+
+    FixedCapacityVector& operator=(FixedCapacityVector&& other) noexcept {
+        if (this != &other) {
+            clear();
+            for (T& item : other) {
+                push_back(std::move(item));
+            }
+            other.clear();
+        }
+        return *this;
+    }
+
+    ~FixedCapacityVector() { clear(); }
+
+    void push_back(const T& item) {
+        assert(count < CAPACITY && "FixedCapacityVector is full!");
+        new (&buffer[count]) T(item);
+        ++count;
+    }
+
+    void push_back(T&& item) {
+        assert(count < CAPACITY && "FixedCapacityVector is full!");
+        new (&buffer[count]) T(std::move(item));
+        ++count;
+    }
+
+    void pop_back() {
+        assert(count > 0 && "FixedCapacityVector is empty!");
+        --count;
+        data()[count].~T();
+    }
+
+    // Removes the items of [first, last) and moves the following items forward.
+    iterator erase(iterator first, iterator last) {
+        const iterator newEnd = std::move(last, end(), first);
+        while (end() != newEnd) {
+            pop_back();
+        }
+        return first;
+    }
+
+    void clear() {
+        while (count > 0) {
+            pop_back();
+        }
+    }
+
+    // The capacity is fixed, there is nothing to reserve.
+    void reserve(std::size_t) {}
+
+    void swap(FixedCapacityVector& other) noexcept {
+        FixedCapacityVector& shorter = count < other.count ? *this : other;
+        FixedCapacityVector& longer = count < other.count ? other : *this;
+
+        using std::swap;
+        for (std::size_t i = 0; i < shorter.count; ++i) {
+            swap(shorter[i], longer[i]);
+        }
+
+        const std::size_t common = shorter.count;
+        for (std::size_t i = common; i < longer.count; ++i) {
+            shorter.push_back(std::move(longer[i]));
+        }
+        while (longer.count > common) {
+            longer.pop_back();
+        }
+    }
+
+    T& operator[](const std::size_t index) { return data()[index]; }
+
+    const T& operator[](const std::size_t index) const { return data()[index]; }
+
+    T& back() { return data()[count - 1]; }
+
+    const T& back() const { return data()[count - 1]; }
+
+    T* data() { return reinterpret_cast<T*>(&buffer[0]); }
+
+    const T* data() const { return reinterpret_cast<const T*>(&buffer[0]); }
+
+    iterator begin() { return data(); }
+
+    iterator end() { return data() + count; }
+
+    const_iterator begin() const { return data(); }
+
+    const_iterator end() const { return data() + count; }
+
+    std::size_t size() const { return count; }
+
+    bool empty() const { return count == 0; }
+
+    static constexpr std::size_t capacity() { return CAPACITY; }
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type buffer[CAPACITY];
+    std::size_t count = 0;
+};
+
+} // namespace cserna
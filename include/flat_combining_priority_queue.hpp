@@ -0,0 +1,293 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "dynamic_priority_queue.hpp"
+#include "spin_lock.hpp"
+
+namespace cserna {
+
+// Thread-safe front end for DynamicPriorityQueue based on flat combining (Hendler, Incze, Shavit and Tzafrir, "Flat
+// Combining and the Synchronization-Parallelism Tradeoff", 2010). Instead of every thread taking the queue lock in
+// turn, threads publish their request in a slot of their own and whoever gets the lock serves all published requests
+// at once. A round applies the updates and removals, answers the pops from the pushed items and the top of the heap,
+// whichever is better, and inserts the remaining pushed items with a single pushBulk.
+//
+// Only the combiner touches the queue, so any index function can be used. Every thread works through its own Handle.
+// Each handle owns one request slot, which holds an item, so T has to be default constructible.
+template <typename T,
+        typename IndexFunction,
+        typename ThreeWayComparator,
+        std::size_t INITIAL_CAPACITY = 0,
+        std::size_t MAX_CAPACITY = std::numeric_limits<std::size_t>::max(),
+        std::size_t ARITY = 2>
+class FlatCombiningPriorityQueue {
+    using Queue = DynamicPriorityQueue<T, IndexFunction, ThreeWayComparator, INITIAL_CAPACITY, MAX_CAPACITY, ARITY>;
+
+    enum Request { NONE, PUSH, POP, UPDATE, REMOVE, DONE };
+
+    struct Slot {
+        std::atomic<bool> taken{false};
+        std::atomic<int> request{NONE};
+        // The pushed item, the popped item, or the item to update or remove.
+        T item{};
+        // Whether a pop found an item, or the item to update or remove was queued.
+        bool found = false;
+        void (*apply)(void*, T&) = nullptr;
+        void* change = nullptr;
+        std::exception_ptr error;
+    };
+
+public:
+    // Frees its slot when it is destroyed, so the handles of finished threads can be replaced by new ones. A handle
+    // must not outlive its queue.
+    class Handle {
+    public:
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+
+        Handle(Handle&& other) noexcept : owner{other.owner}, slot{other.slot} { other.slot = nullptr; }
+
+        Handle& operator=(Handle&& other) noexcept {
+            if (this != &other) {
+                release();
+                owner = other.owner;
+                slot = other.slot;
+                other.slot = nullptr;
+            }
+            return *this;
+        }
+
+        ~Handle() { release(); }
+
+        // Rethrows std::overflow_error if the queue is full.
+        void push(T item) {
+            slot->item = std::move(item);
+            execute(PUSH);
+        }
+
+        // Moves the best item to the output and returns true, or returns false if the queue is empty.
+        bool tryPop(T& out) {
+            execute(POP);
+            if (slot->found) {
+                out = std::move(slot->item);
+            }
+            return slot->found;
+        }
+
+        // Calls change(item) in the combiner, which is the only thread comparing items, and moves the item to its new
+        // place. Returns false without calling change if the item is not queued.
+        template <typename Change>
+        bool update(T item, Change change) {
+            slot->item = std::move(item);
+            slot->apply = &applyChange<Change>;
+            slot->change = &change;
+            execute(UPDATE);
+            return slot->found;
+        }
+
+        // Returns false if the item is not queued.
+        bool remove(T item) {
+            slot->item = std::move(item);
+            execute(REMOVE);
+            return slot->found;
+        }
+
+    private:
+        friend class FlatCombiningPriorityQueue;
+
+        Handle(FlatCombiningPriorityQueue* owner, Slot* slot) : owner{owner}, slot{slot} {}
+
+        template <typename Change>
+        static void applyChange(void* change, T& item) {
+            (*static_cast<Change*>(change))(item);
+        }
+
+        void release() {
+            if (slot != nullptr) {
+                slot->taken.store(false, std::memory_order_release);
+                slot = nullptr;
+            }
+        }
+
+        void execute(const Request request) {
+            slot->request.store(request, std::memory_order_release);
+
+            while (slot->request.load(std::memory_order_acquire) != DONE) {
+                if (owner->combinerLock.try_lock()) {
+                    owner->combine();
+                    owner->combinerLock.unlock();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+
+            slot->request.store(NONE, std::memory_order_relaxed);
+
+            if (slot->error) {
+                std::exception_ptr error = slot->error;
+                slot->error = nullptr;
+                std::rethrow_exception(error);
+            }
+        }
+
+        FlatCombiningPriorityQueue* owner;
+        Slot* slot;
+    };
+
+    // Every thread needs a Handle, of which at most maxThreads can exist at the same time.
+    explicit FlatCombiningPriorityQueue(const std::size_t maxThreads,
+            const ThreeWayComparator& comparator = ThreeWayComparator(),
+            IndexFunction indexFunction = IndexFunction())
+            : comparator{comparator}, queue{comparator, std::move(indexFunction)} {
+        slots.reserve(maxThreads);
+        for (std::size_t i = 0; i < maxThreads; ++i) {
+            slots.emplace_back(new Slot());
+        }
+        pushed.reserve(maxThreads);
+        popped.reserve(maxThreads);
+        batch.reserve(maxThreads);
+    }
+
+    ~FlatCombiningPriorityQueue() = default;
+    FlatCombiningPriorityQueue(const FlatCombiningPriorityQueue&) = delete;
+    FlatCombiningPriorityQueue(FlatCombiningPriorityQueue&&) = delete;
+    FlatCombiningPriorityQueue& operator=(const FlatCombiningPriorityQueue&) = delete;
+    FlatCombiningPriorityQueue& operator=(FlatCombiningPriorityQueue&&) = delete;
+
+    // Thread-safe; throws std::overflow_error if all slots are taken by live handles.
+    Handle handle() {
+        for (auto& slot : slots) {
+            bool taken = false;
+            if (!slot->taken.load(std::memory_order_relaxed) &&
+                    slot->taken.compare_exchange_strong(taken, true, std::memory_order_acquire)) {
+                return Handle(this, slot.get());
+            }
+        }
+
+        throw std::overflow_error("All combining slots are in use:" + std::to_string(slots.size()));
+    }
+
+    // A snapshot that may be outdated as soon as it is returned.
+    std::size_t size() const { return count.load(std::memory_order_relaxed); }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    // Serves all published requests; called with the combiner lock held.
+    void combine() {
+        pushed.clear();
+        popped.clear();
+
+        for (auto& slot : slots) {
+            switch (slot->request.load(std::memory_order_acquire)) {
+            case PUSH:
+                pushed.push_back(slot.get());
+                break;
+            case POP:
+                popped.push_back(slot.get());
+                break;
+            case UPDATE:
+                slot->found = queue.contains(slot->item);
+                if (slot->found) {
+                    // The change goes to the queued copy, which differs from the slot's when items are values.
+                    Slot* const requester = slot.get();
+                    queue.update(slot->item, [requester](T& item) { requester->apply(requester->change, item); });
+                }
+                finish(*slot);
+                break;
+            case REMOVE:
+                slot->found = queue.contains(slot->item);
+                queue.remove(slot->item);
+                finish(*slot);
+                break;
+            default:
+                break;
+            }
+        }
+
+        // The best pushed items may go straight to the pops without ever entering the heap.
+        std::sort(pushed.begin(), pushed.end(), [this](const Slot* lhs, const Slot* rhs) {
+            return comparator(lhs->item, rhs->item) < 0;
+        });
+
+        std::size_t nextPushed = 0;
+        for (Slot* slot : popped) {
+            const bool fromPushed = nextPushed < pushed.size() &&
+                    (queue.empty() || comparator(pushed[nextPushed]->item, queue.top()) < 0);
+
+            if (fromPushed) {
+                slot->item = std::move(pushed[nextPushed]->item);
+                finish(*pushed[nextPushed]);
+                ++nextPushed;
+                slot->found = true;
+            } else if (!queue.empty()) {
+                slot->item = queue.pop();
+                slot->found = true;
+            } else {
+                slot->found = false;
+            }
+
+            finish(*slot);
+        }
+
+        insertPushed(nextPushed);
+
+        count.store(queue.size(), std::memory_order_relaxed);
+    }
+
+    void insertPushed(const std::size_t first) {
+        batch.clear();
+        for (std::size_t i = first; i < pushed.size(); ++i) {
+            batch.push_back(std::move(pushed[i]->item));
+        }
+
+        try {
+            queue.pushBulk(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+        } catch (const std::overflow_error&) {
+            // pushBulk checks the capacity before it touches the queue or the batch; fill up what is left one by one.
+            for (std::size_t i = first; i < pushed.size(); ++i) {
+                try {
+                    queue.push(std::move(batch[i - first]));
+                } catch (...) {
+                    pushed[i]->error = std::current_exception();
+                }
+            }
+        } catch (...) {
+            // Anything else may come from the middle of the append, after some items were moved; report it to every
+            // pusher of the round instead of pushing what is left of the batch.
+            for (std::size_t i = first; i < pushed.size(); ++i) {
+                pushed[i]->error = std::current_exception();
+            }
+        }
+
+        for (std::size_t i = first; i < pushed.size(); ++i) {
+            finish(*pushed[i]);
+        }
+    }
+
+    static void finish(Slot& slot) { slot.request.store(DONE, std::memory_order_release); }
+
+    ThreeWayComparator comparator;
+    Queue queue;
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::atomic<std::size_t> count{0};
+    detail::SpinLock combinerLock;
+    // Scratch space of the combiner
+    std::vector<Slot*> pushed;
+    std::vector<Slot*> popped;
+    std::vector<T> batch;
+};
+
+} // namespace cserna
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cserna {
+
+// Drop-in replacement for NonIntrusiveIndexFunction backed by an open-addressing Robin Hood hash table. Entries are
+// stored inline in a single array, so a lookup touches one or two cache lines instead of chasing a node pointer.
+// Entries are erased with backward shifting (no tombstones) when the queue reports that an item left the queue.
+template <typename T,
+        typename Hash = std::hash<T>,
+        typename Equal = std::equal_to<T>,
+        typename IndexType = std::size_t>
+class FlatIndexFunction {
+public:
+    explicit FlatIndexFunction(const Hash& hash = Hash(), const Equal& equal = Equal())
+            : hash{hash}, equal{equal}, slots{}, count{0}, shift{64} {}
+
+    FlatIndexFunction(const FlatIndexFunction& other)
+            : hash{other.hash}, equal{other.equal}, slots(other.slots.size()), count{other.count}, shift{other.shift} {
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            if (other.slots[i].distance != 0) {
+                new (&slots[i].storage) T(other.slots[i].key());
+                slots[i].index = other.slots[i].index;
+                slots[i].distance = other.slots[i].distance;
+            }
+        }
+    }
+
+    FlatIndexFunction(FlatIndexFunction&& other) noexcept
+            : hash{std::move(other.hash)},
+              equal{std::move(other.equal)},
+              slots{std::move(other.slots)},
+              count{other.count},
+              shift{other.shift} {
+        other.slots.clear();
+        other.count = 0;
+        other.shift = 64;
+    }
+
+    FlatIndexFunction& operator=(FlatIndexFunction other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~FlatIndexFunction() { destroyAll(); }
+
+    IndexType& operator()(T& item) {
+        const std::size_t position = find(item);
+        if (position != notFound) {
+            return slots[position].index;
+        }
+
+        return slots[insert(item)].index;
+    }
+
+    IndexType operator()(const T& item) const {
+        const std::size_t position = find(item);
+        if (position == notFound) {
+            return std::numeric_limits<IndexType>::max();
+        } else {
+            return slots[position].index;
+        }
+    }
+
+    // Called by the queue when an item leaves it.
+    void erase(const T& item) {
+        std::size_t position = find(item);
+        if (position == notFound) {
+            return;
+        }
+
+        slots[position].key().~T();
+
+        // Shift the following entries of the cluster back by one so that lookups never need tombstones.
+        const std::size_t mask = slots.size() - 1;
+        std::size_t next = (position + 1) & mask;
+        while (slots[next].distance > 1) {
+            new (&slots[position].storage) T(std::move(slots[next].key()));
+            slots[position].index = slots[next].index;
+            slots[position].distance = slots[next].distance - 1;
+            slots[next].key().~T();
+
+            position = next;
+            next = (next + 1) & mask;
+        }
+
+        slots[position].distance = 0;
+        --count;
+    }
+
+    // Makes room for the given number of items without rehashing.
+    void reserve(const std::size_t itemCount) {
+        std::size_t capacity = minimumCapacity;
+        while (capacity * maxLoadNumerator / maxLoadDenominator < itemCount) {
+            capacity *= 2;
+        }
+
+        if (capacity > slots.size()) {
+            rehash(capacity);
+        }
+    }
+
+    std::size_t size() const { return count; }
+
+    void swap(FlatIndexFunction& other) noexcept {
+        using std::swap;
+        swap(hash, other.hash);
+        swap(equal, other.equal);
+        slots.swap(other.slots);
+        swap(count, other.count);
+        swap(shift, other.shift);
+    }
+
+private:
+    struct Slot {
+        T& key() { return *reinterpret_cast<T*>(&storage); }
+        const T& key() const { return *reinterpret_cast<const T*>(&storage); }
+
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        IndexType index = std::numeric_limits<IndexType>::max();
+        // Zero for empty slots, otherwise one plus the distance from the home slot of the key.
+        std::uint32_t distance = 0;
+    };
+
+    static constexpr std::size_t notFound = std::numeric_limits<std::size_t>::max();
+    static constexpr std::size_t minimumCapacity = 16;
+    static constexpr std::size_t maxLoadNumerator = 7;
+    static constexpr std::size_t maxLoadDenominator = 8;
+
+    // Fibonacci hashing spreads hashes with weak low bits (e.g. identity hashed pointers) over the whole table.
+    std::size_t homeSlot(const T& item) const {
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(hash(item)) * 11400714819323198485ull) >> shift);
+    }
+
+    std::size_t find(const T& item) const {
+        if (count == 0) {
+            return notFound;
+        }
+
+        const std::size_t mask = slots.size() - 1;
+        std::size_t position = homeSlot(item);
+        std::uint32_t distance = 1;
+
+        // Robin Hood invariant: the key cannot be further from home than the entry occupying the probed slot.
+        while (slots[position].distance >= distance) {
+            if (slots[position].distance == distance && equal(slots[position].key(), item)) {
+                return position;
+            }
+
+            position = (position + 1) & mask;
+            ++distance;
+        }
+
+        return notFound;
+    }
+
+    // Inserts a key that is not in the table yet with the "not in queue" index and returns its position.
+    std::size_t insert(const T& item) {
+        if ((count + 1) * maxLoadDenominator > slots.size() * maxLoadNumerator) {
+            rehash(slots.empty() ? minimumCapacity : slots.size() * 2);
+        }
+
+        ++count;
+        return place(T(item), std::numeric_limits<IndexType>::max());
+    }
+
+    std::size_t place(T&& item, IndexType index) {
+        const std::size_t mask = slots.size() - 1;
+        std::size_t position = homeSlot(item);
+        std::uint32_t distance = 1;
+        std::size_t placedPosition = notFound;
+
+        T carried(std::move(item));
+
+        while (true) {
+            Slot& slot = slots[position];
+
+            if (slot.distance == 0) {
+                new (&slot.storage) T(std::move(carried));
+                slot.index = index;
+                slot.distance = distance;
+                return placedPosition == notFound ? position : placedPosition;
+            }
+
+            // Take the slot from richer entries (closer to home) and carry them on.
+            if (slot.distance < distance) {
+                using std::swap;
+                swap(carried, slot.key());
+                swap(index, slot.index);
+                swap(distance, slot.distance);
+
+                if (placedPosition == notFound) {
+                    placedPosition = position;
+                }
+            }
+
+            position = (position + 1) & mask;
+            ++distance;
+        }
+    }
+
+    void rehash(const std::size_t capacity) {
+        assert((capacity & (capacity - 1)) == 0 && "Capacity must be a power of two");
+
+        std::vector<Slot> oldSlots(capacity);
+        oldSlots.swap(slots);
+
+        shift = 64;
+        for (std::size_t size = capacity; size > 1; size /= 2) {
+            --shift;
+        }
+
+        for (auto& slot : oldSlots) {
+            if (slot.distance != 0) {
+                place(std::move(slot.key()), slot.index);
+                slot.key().~T();
+                slot.distance = 0;
+            }
+        }
+    }
+
+    void destroyAll() {
+        for (auto& slot : slots) {
+            if (slot.distance != 0) {
+                slot.key().~T();
+                slot.distance = 0;
+            }
+        }
+    }
+
+    Hash hash;
+    Equal equal;
+    std::vector<Slot> slots;
+    std::size_t count;
+    unsigned shift;
+};
+
+template <typename T, typename Hash, typename Equal, typename IndexType>
+constexpr std::size_t FlatIndexFunction<T, Hash, Equal, IndexType>::notFound;
+
+template <typename T, typename Hash, typename Equal, typename IndexType>
+constexpr std::size_t FlatIndexFunction<T, Hash, Equal, IndexType>::minimumCapacity;
+
+template <typename T, typename Hash, typename Equal, typename IndexType>
+constexpr std::size_t FlatIndexFunction<T, Hash, Equal, IndexType>::maxLoadNumerator;
+
+template <typename T, typename Hash, typename Equal, typename IndexType>
+constexpr std::size_t FlatIndexFunction<T, Hash, Equal, IndexType>::maxLoadDenominator;
+
+} // namespace cserna
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <sys/mman.h>
+
+namespace cserna {
+
+enum class HugePageMode {
+    // Regular anonymous mapping with madvise(MADV_HUGEPAGE); the kernel backs it with huge pages when it can.
+    TRANSPARENT,
+    // MAP_HUGETLB mapping from the reserved huge page pool, falling back to TRANSPARENT if none are available.
+    EXPLICIT
+};
+
+// POSIX storage for DynamicPriorityQueue with very large heaps. The array lives in its own anonymous mapping backed by
+// huge pages to cut TLB misses, and grows with mremap (Linux) so the items are never copied. The mapping starts on a
+// huge page boundary and spans whole huge pages, since transparent huge pages can only back aligned 2 MiB ranges of it.
+// The first item is placed so that item 1 starts on a cache line: the children of node i start at index ARITY * i + 1,
+// hence every sibling group is line aligned when ARITY * sizeof(T) is a multiple of the line size.
+//
+// Items are relocated as raw bytes, so T has to be trivially copyable.
+template <typename T>
+class HugePageVector {
+    static_assert(std::is_trivially_copyable<T>::value, "HugePageVector requires trivially copyable items.");
+    static_assert(alignof(T) <= 64, "Items cannot be aligned beyond a cache line.");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+    static constexpr std::size_t HUGE_PAGE_SIZE = std::size_t{2} << 20;
+
+    explicit HugePageVector(const HugePageMode mode = HugePageMode::TRANSPARENT) : mode{mode} {}
+
+    HugePageVector(const HugePageVector&) = delete;
+    HugePageVector& operator=(const HugePageVector&) = delete;
+
+    HugePageVector(HugePageVector&& other) noexcept
+            : mode{other.mode},
+              mapping{other.mapping},
+              mappingSize{other.mappingSize},
+              hugeTlb{other.hugeTlb},
+              count{other.count} {
+        other.mapping = nullptr;
+        other.mappingSize = 0;
+        other.count = 0;
+    }
+
+    HugePageVector& operator=(HugePageVector&& other) noexcept {
+        HugePageVector(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~HugePageVector() { unmap(mapping, mappingSize); }
+
+    void push_back(const T& item) {
+        if (count == capacity()) {
+            grow(count + 1);
+        }
+
+        data()[count] = item;
+        ++count;
+    }
+
+    void pop_back() {
+        assert(count > 0 && "HugePageVector is empty!");
+        --count;
+    }
+
+    // Removes the items of [first, last) and moves the following items forward.
+    iterator erase(iterator first, iterator last) {
+        std::memmove(static_cast<void*>(first), last, static_cast<std::size_t>(end() - last) * sizeof(T));
+        count -= static_cast<std::size_t>(last - first);
+        return first;
+    }
+
+    void clear() { count = 0; }
+
+    void reserve(const std::size_t newCapacity) {
+        if (newCapacity > capacity()) {
+            grow(newCapacity);
+        }
+    }
+
+    void swap(HugePageVector& other) noexcept {
+        std::swap(mode, other.mode);
+        std::swap(mapping, other.mapping);
+        std::swap(mappingSize, other.mappingSize);
+        std::swap(hugeTlb, other.hugeTlb);
+        std::swap(count, other.count);
+    }
+
+    T& operator[](const std::size_t index) { return data()[index]; }
+
+    const T& operator[](const std::size_t index) const { return data()[index]; }
+
+    T& back() { return data()[count - 1]; }
+
+    const T& back() const { return data()[count - 1]; }
+
+    T* data() { return mapping == nullptr ? nullptr : reinterpret_cast<T*>(static_cast<char*>(mapping) + offset()); }
+
+    const T* data() const {
+        return mapping == nullptr ? nullptr
+                                  : reinterpret_cast<const T*>(static_cast<const char*>(mapping) + offset());
+    }
+
+    iterator begin() { return data(); }
+
+    iterator end() { return data() + count; }
+
+    const_iterator begin() const { return data(); }
+
+    const_iterator end() const { return data() + count; }
+
+    std::size_t size() const { return count; }
+
+    bool empty() const { return count == 0; }
+
+    std::size_t capacity() const { return mapping == nullptr ? 0 : (mappingSize - offset()) / sizeof(T); }
+
+private:
+    // Padding in front of item 0 that puts item 1 on a cache line boundary.
+    static constexpr std::size_t offset() {
+        return (CACHE_LINE_SIZE - sizeof(T) % CACHE_LINE_SIZE) % CACHE_LINE_SIZE;
+    }
+
+    static void unmap(void* address, const std::size_t length) {
+        if (address != nullptr) {
+            munmap(address, length);
+        }
+    }
+
+    // Grows the mapping geometrically in whole huge pages, keeping it huge page aligned.
+    void grow(const std::size_t minimumCapacity) {
+        std::size_t newSize = mappingSize == 0 ? HUGE_PAGE_SIZE : mappingSize * 2;
+        while ((newSize - offset()) / sizeof(T) < minimumCapacity) {
+            newSize *= 2;
+        }
+
+#ifdef __linux__
+        // Huge TLB mappings cannot be resized on all kernels, so only regular mappings are remapped: in place if the
+        // address space behind the mapping is free, otherwise the pages are moved onto a new aligned range.
+        if (mapping != nullptr && !hugeTlb) {
+            void* remapped = mremap(mapping, mappingSize, newSize, 0);
+            if (remapped == MAP_FAILED) {
+                void* target = mapAligned(newSize);
+                remapped = mremap(mapping, mappingSize, newSize, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+                if (remapped == MAP_FAILED) {
+                    unmap(target, newSize);
+                    throw std::bad_alloc();
+                }
+            }
+
+            mapping = remapped;
+            mappingSize = newSize;
+            adviseHugePages();
+            return;
+        }
+#endif
+
+        bool newHugeTlb = false;
+        void* newMapping = map(newSize, newHugeTlb);
+        if (mapping != nullptr) {
+            std::memcpy(static_cast<char*>(newMapping) + offset(), data(), count * sizeof(T));
+            unmap(mapping, mappingSize);
+        }
+
+        mapping = newMapping;
+        mappingSize = newSize;
+        hugeTlb = newHugeTlb;
+        adviseHugePages();
+    }
+
+    void* map(const std::size_t length, bool& isHugeTlb) const {
+#ifdef MAP_HUGETLB
+        if (mode == HugePageMode::EXPLICIT) {
+            void* address =
+                    mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (address != MAP_FAILED) {
+                isHugeTlb = true;
+                return address;
+            }
+        }
+#endif
+
+        isHugeTlb = false;
+        return mapAligned(length);
+    }
+
+    // Maps a huge page more than needed and trims the mapping to an aligned range of the given length.
+    static void* mapAligned(const std::size_t length) {
+        const std::size_t reservedLength = length + HUGE_PAGE_SIZE;
+        void* address = mmap(nullptr, reservedLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (address == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+
+        const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(address);
+        const std::uintptr_t alignedStart = (start + HUGE_PAGE_SIZE - 1) & ~std::uintptr_t{HUGE_PAGE_SIZE - 1};
+        const std::uintptr_t alignedEnd = alignedStart + length;
+        if (alignedStart > start) {
+            munmap(address, alignedStart - start);
+        }
+        if (start + reservedLength > alignedEnd) {
+            munmap(reinterpret_cast<void*>(alignedEnd), start + reservedLength - alignedEnd);
+        }
+
+        return reinterpret_cast<void*>(alignedStart);
+    }
+
+    void adviseHugePages() {
+#ifdef MADV_HUGEPAGE
+        if (!hugeTlb) {
+            // Only a hint; the mapping works without huge pages as well.
+            madvise(mapping, mappingSize, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    HugePageMode mode;
+    void* mapping = nullptr;
+    std::size_t mappingSize = 0;
+    bool hugeTlb = false;
+    std::size_t count = 0;
+};
+
+template <typename T>
+constexpr std::size_t HugePageVector<T>::CACHE_LINE_SIZE;
+
+template <typename T>
+constexpr std::size_t HugePageVector<T>::HUGE_PAGE_SIZE;
+
+} // namespace cserna
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "dynamic_priority_queue.hpp"
+
+namespace cserna {
+
+template <typename T, typename KeyProjection>
+struct ProjectedKey {
+    using type = typename std::decay<decltype(std::declval<const KeyProjection&>()(std::declval<const T&>()))>::type;
+};
+
+// Variant of DynamicPriorityQueue that caches the priority of every item in a dense array next to the items.
+// The key is extracted by KeyProjection on push and on update; sifting compares only the cached keys, so the items
+// themselves are only touched to move them and to maintain their index.
+template <typename T,
+        typename IndexFunction,
+        typename KeyProjection,
+        typename ThreeWayKeyComparator = ThreeWayComparatorAdapter<typename ProjectedKey<T, KeyProjection>::type>,
+        std::size_t INITIAL_CAPACITY = 0,
+        std::size_t MAX_CAPACITY = std::numeric_limits<std::size_t>::max(),
+        std::size_t ARITY = 2,
+        typename IndexType = typename detail::IndexTypeOf<IndexFunction, T>::type>
+class KeyedDynamicPriorityQueue {
+    static_assert(ARITY >= 2, "The heap arity must be at least two.");
+    static_assert(std::is_integral<IndexType>::value && std::is_unsigned<IndexType>::value,
+            "The index type must be an unsigned integer.");
+    static_assert(std::is_same<decltype(std::declval<IndexFunction&>()(std::declval<T&>())), IndexType&>::value,
+            "The index function must return a reference to IndexType.");
+
+public:
+    using Key = typename ProjectedKey<T, KeyProjection>::type;
+
+    explicit KeyedDynamicPriorityQueue(const KeyProjection& keyProjection = KeyProjection(),
+            const ThreeWayKeyComparator& comparator = ThreeWayKeyComparator(),
+            IndexFunction indexFunction = IndexFunction())
+            : keyProjection{keyProjection}, comparator{comparator}, indexFunction{std::move(indexFunction)}, keys{},
+              queue{} {
+        keys.reserve(INITIAL_CAPACITY);
+        queue.reserve(INITIAL_CAPACITY);
+        detail::reserveIndex(this->indexFunction, INITIAL_CAPACITY, 0);
+    }
+
+    ~KeyedDynamicPriorityQueue() = default;
+    KeyedDynamicPriorityQueue(const KeyedDynamicPriorityQueue&) = delete;
+    KeyedDynamicPriorityQueue(KeyedDynamicPriorityQueue&&) noexcept = default;
+    KeyedDynamicPriorityQueue& operator=(const KeyedDynamicPriorityQueue&) = delete;
+    KeyedDynamicPriorityQueue& operator=(KeyedDynamicPriorityQueue&&) noexcept = default;
+
+    void push(T item) {
+        if (queue.size() == capacityLimit()) {
+            throw std::overflow_error("Priority queue reached its maximum capacity:" + std::to_string(capacityLimit()));
+        }
+
+        const std::size_t index = queue.size();
+        indexFunction(item) = static_cast<IndexType>(index);
+        keys.push_back(keyProjection(item));
+        queue.push_back(std::move(item));
+
+        if (index != 0) {
+            siftUp(index);
+        }
+    }
+
+    T pop() {
+        if (queue.size() == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        T top_item(std::move(queue[0]));
+
+        assert(indexFunction(top_item) == 0 &&
+                "Internal index of top item was "
+                "non-zero");
+
+        invalidateIndex(top_item);
+
+        if (queue.size() > 1) {
+            moveLastTo(0);
+            siftDown(0);
+        } else {
+            keys.pop_back();
+            queue.pop_back();
+        }
+
+        return top_item;
+    }
+
+    T& top() {
+        if (queue.size() == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return queue[0];
+    }
+
+    const T& top() const {
+        if (queue.size() == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return queue[0];
+    }
+
+    const Key& topKey() const {
+        if (queue.size() == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return keys[0];
+    }
+
+    void remove(T item) {
+        if (!contains(item)) {
+            return;
+        }
+
+        const std::size_t index = indexFunction(item);
+        // Invalidate the item's index.
+        invalidateIndex(item);
+
+        if (index == queue.size() - 1) {
+            keys.pop_back();
+            queue.pop_back();
+            return;
+        }
+
+        moveLastTo(index);
+
+        if (!siftUp(index)) {
+            siftDown(index);
+        }
+    }
+
+    void clear() {
+        for (std::size_t i = 0; i < queue.size(); i++) {
+            invalidateIndex(queue[i]);
+        }
+        keys.clear();
+        queue.clear();
+    }
+
+    void insertOrUpdate(T item) {
+        if (indexFunction(item) == std::numeric_limits<IndexType>::max()) {
+            // Item is not in the queue yet
+            push(std::move(item));
+        } else {
+            // Already in the queue
+            update(std::move(item));
+        }
+    }
+
+    // Refreshes the cached key from the queued copy of the item and restores the heap property. When the queue holds
+    // the items by value, changes to the caller's copy are not seen; use update(item, change) instead.
+    void update(T item) {
+        const std::size_t originalIndex = indexFunction(item);
+        assert(originalIndex != std::numeric_limits<IndexType>::max() &&
+                "Cannot update a node that is not in the queue!");
+
+        keys[originalIndex] = keyProjection(queue[originalIndex]);
+
+        if (!siftUp(originalIndex)) {
+            siftDown(originalIndex);
+        }
+    }
+
+    // Calls change on the queued copy of the item, then refreshes its cached key and moves it to its new place.
+    template <typename Change>
+    void update(const T& item, Change change) {
+        const std::size_t originalIndex = indexFunction(item);
+        assert(originalIndex != std::numeric_limits<IndexType>::max() &&
+                "Cannot update a node that is not in the queue!");
+
+        change(queue[originalIndex]);
+        keys[originalIndex] = keyProjection(queue[originalIndex]);
+
+        if (!siftUp(originalIndex)) {
+            siftDown(originalIndex);
+        }
+    }
+
+    template <typename Action>
+    void forEach(Action action = Action()) {
+        for (auto& item : queue) {
+            action(item);
+        }
+    }
+
+    std::size_t size() const { return queue.size(); }
+
+    bool empty() const { return queue.size() == 0; }
+
+    bool contains(const T& item) const { return indexFunction(item) != std::numeric_limits<IndexType>::max(); }
+
+private:
+    // Positions have to stay below the "not in queue" value of the index type.
+    static constexpr std::size_t capacityLimit() {
+        return MAX_CAPACITY < std::numeric_limits<IndexType>::max() ? MAX_CAPACITY
+                                                                    : std::numeric_limits<IndexType>::max();
+    }
+
+    void invalidateIndex(T& item) { detail::invalidateIndex(indexFunction, item, 0); }
+
+    // Moves the last item (and its key) into the given slot and shrinks the queue by one.
+    void moveLastTo(const std::size_t index) {
+        const std::size_t lastIndex = queue.size() - 1;
+
+        indexFunction(queue[lastIndex]) = static_cast<IndexType>(index);
+        keys[index] = std::move(keys[lastIndex]);
+        queue[index] = std::move(queue[lastIndex]);
+
+        keys.pop_back();
+        queue.pop_back();
+    }
+
+    // Returns true if the item was moved.
+    bool siftUp(const std::size_t index) {
+        Key key = std::move(keys[index]);
+        T item = std::move(queue[index]);
+        std::size_t currentIndex = index;
+
+        while (currentIndex > 0) {
+            const std::size_t parentIndex = (currentIndex - 1) / ARITY;
+
+            if (comparator(key, keys[parentIndex]) >= 0) {
+                break;
+            }
+
+            // Move parent down and update its index
+            indexFunction(queue[parentIndex]) = static_cast<IndexType>(currentIndex);
+            keys[currentIndex] = std::move(keys[parentIndex]);
+            queue[currentIndex] = std::move(queue[parentIndex]);
+            currentIndex = parentIndex;
+        }
+
+        indexFunction(item) = static_cast<IndexType>(currentIndex);
+        keys[currentIndex] = std::move(key);
+        queue[currentIndex] = std::move(item);
+
+        return currentIndex != index;
+    }
+
+    // Returns true if the item was moved.
+    bool siftDown(const std::size_t index) {
+        Key key = std::move(keys[index]);
+        T item = std::move(queue[index]);
+
+        std::size_t currentIndex = index;
+        const std::size_t size = queue.size();
+
+        while (true) {
+            const std::size_t firstChildIndex = currentIndex * ARITY + 1;
+            if (firstChildIndex >= size) {
+                break;
+            }
+
+            const std::size_t lastChildIndex = firstChildIndex + ARITY < size ? firstChildIndex + ARITY : size;
+            std::size_t betterChildIndex = firstChildIndex;
+
+            for (std::size_t childIndex = firstChildIndex + 1; childIndex < lastChildIndex; ++childIndex) {
+                if (comparator(keys[betterChildIndex], keys[childIndex]) > 0) {
+                    betterChildIndex = childIndex;
+                }
+            }
+
+            if (comparator(key, keys[betterChildIndex]) <= 0) {
+                break;
+            }
+
+            indexFunction(queue[betterChildIndex]) = static_cast<IndexType>(currentIndex);
+            keys[currentIndex] = std::move(keys[betterChildIndex]);
+            queue[currentIndex] = std::move(queue[betterChildIndex]);
+            currentIndex = betterChildIndex;
+        }
+
+        indexFunction(item) = static_cast<IndexType>(currentIndex);
+        keys[currentIndex] = std::move(key);
+        queue[currentIndex] = std::move(item);
+
+        return currentIndex != index;
+    }
+
+    KeyProjection keyProjection;
+    ThreeWayKeyComparator comparator;
+    IndexFunction indexFunction;
+    std::vector<Key> keys;
+    std::vector<T> queue;
+};
+
+} // namespace cserna
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cserna {
+
+// POSIX storage for DynamicPriorityQueue that keeps the heap array in a memory-mapped file, so a restarted process can
+// reopen the file in O(1) and continue with the same heap. The file starts with a small header (size, capacity and a
+// format version), followed by the items. Every push and pop updates the size in the header; sync() flushes the
+// mapping to disk, e.g. at a checkpoint.
+//
+// The header also holds a clean flag. It is cleared when the file is opened and on the first change after a sync(), and
+// it is set again by sync() and by the destructor, unless the destructor runs during stack unwinding: an exception in
+// the middle of a sift leaves the heap out of order, just like a process that dies there. A file that was not closed
+// cleanly is rejected on reopen. The file is locked with flock() while it is open, so no other process can map it at
+// the same time.
+//
+// Items are stored as raw bytes, so T has to be trivially copyable. When the items carry their own position (an
+// intrusive index function) the reopened queue is ready immediately; otherwise call reindex() on the queue.
+template <typename T>
+class MappedFileVector {
+    static_assert(std::is_trivially_copyable<T>::value, "MappedFileVector requires trivially copyable items.");
+    static_assert(alignof(T) <= 64, "Items cannot be aligned beyond the header.");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr std::uint32_t VERSION = 2;
+
+    // Opens the file, or creates it if it does not exist or is empty. Throws std::system_error if another
+    // MappedFileVector has the file open, and std::runtime_error if the file was written with another format version
+    // or item size or was not closed cleanly.
+    explicit MappedFileVector(const std::string& path, const std::size_t initialCapacity = 1024) {
+        fileDescriptor = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fileDescriptor < 0) {
+            throw std::system_error(errno, std::generic_category(), "Cannot open " + path);
+        }
+
+        try {
+            if (::flock(fileDescriptor, LOCK_EX | LOCK_NB) != 0) {
+                throw std::system_error(errno, std::generic_category(), "Priority queue file is in use: " + path);
+            }
+            openMapping(path, initialCapacity > 0 ? initialCapacity : 1);
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    MappedFileVector(const MappedFileVector&) = delete;
+    MappedFileVector& operator=(const MappedFileVector&) = delete;
+
+    MappedFileVector(MappedFileVector&& other) noexcept
+            : fileDescriptor{other.fileDescriptor},
+              mapping{other.mapping},
+              mappingSize{other.mappingSize},
+              dirty{other.dirty} {
+        other.fileDescriptor = -1;
+        other.mapping = nullptr;
+        other.mappingSize = 0;
+        other.dirty = false;
+    }
+
+    MappedFileVector& operator=(MappedFileVector&& other) noexcept {
+        MappedFileVector(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~MappedFileVector() {
+        if (mapping != nullptr && !unwinding()) {
+            header()->clean = 1;
+        }
+        release();
+    }
+
+    void push_back(const T& item) {
+        if (size() == capacity()) {
+            reserve(capacity() * 2);
+        }
+
+        data()[header()->size] = item;
+        ++header()->size;
+    }
+
+    void pop_back() {
+        assert(size() > 0 && "MappedFileVector is empty!");
+        markDirty();
+        --header()->size;
+    }
+
+    // Removes the items of [first, last) and moves the following items forward.
+    iterator erase(iterator first, iterator last) {
+        markDirty();
+        std::memmove(static_cast<void*>(first), last, static_cast<std::size_t>(end() - last) * sizeof(T));
+        header()->size -= static_cast<std::size_t>(last - first);
+        return first;
+    }
+
+    void clear() {
+        if (mapping != nullptr) {
+            markDirty();
+            header()->size = 0;
+        }
+    }
+
+    // Grows the file and the mapping; the items keep their place in the file.
+    void reserve(const std::size_t newCapacity) {
+        if (newCapacity <= capacity()) {
+            return;
+        }
+
+        const std::size_t newSize = fileSize(newCapacity);
+        resizeFile(newSize);
+
+#ifdef __linux__
+        void* remapped = ::mremap(mapping, mappingSize, newSize, MREMAP_MAYMOVE);
+        if (remapped == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "Cannot grow the priority queue file");
+        }
+        mapping = remapped;
+        mappingSize = newSize;
+#else
+        ::munmap(mapping, mappingSize);
+        mapping = nullptr;
+        mappingSize = newSize;
+        mapFile();
+#endif
+
+        header()->capacity = newCapacity;
+    }
+
+    // Flushes the header and the items to the file, then marks the file clean. The flag goes to disk after the items,
+    // so it never covers items that were not written.
+    void sync() {
+        flush(mappingSize);
+        header()->clean = 1;
+        flush(sizeof(Header));
+        dirty = false;
+    }
+
+    void swap(MappedFileVector& other) noexcept {
+        std::swap(fileDescriptor, other.fileDescriptor);
+        std::swap(mapping, other.mapping);
+        std::swap(mappingSize, other.mappingSize);
+        std::swap(dirty, other.dirty);
+    }
+
+    T& operator[](const std::size_t index) { return data()[index]; }
+
+    const T& operator[](const std::size_t index) const { return data()[index]; }
+
+    T& back() { return data()[size() - 1]; }
+
+    const T& back() const { return data()[size() - 1]; }
+
+    // Every mutable access may change the items, so the first one after a sync() marks the file as not clean.
+    T* data() {
+        markDirty();
+        return mapping == nullptr ? nullptr : reinterpret_cast<T*>(static_cast<char*>(mapping) + sizeof(Header));
+    }
+
+    const T* data() const {
+        return mapping == nullptr ? nullptr
+                                  : reinterpret_cast<const T*>(static_cast<const char*>(mapping) + sizeof(Header));
+    }
+
+    iterator begin() { return data(); }
+
+    iterator end() { return data() + size(); }
+
+    const_iterator begin() const { return data(); }
+
+    const_iterator end() const { return data() + size(); }
+
+    // A moved-from vector is empty.
+    std::size_t size() const { return mapping == nullptr ? 0 : static_cast<std::size_t>(header()->size); }
+
+    bool empty() const { return size() == 0; }
+
+    std::size_t capacity() const { return mapping == nullptr ? 0 : static_cast<std::size_t>(header()->capacity); }
+
+private:
+    static constexpr std::uint64_t MAGIC = 0x5150594d414e5944; // "DYNAMYPQ"
+
+    // One cache line, so the items that follow are line aligned as well.
+    struct alignas(64) Header {
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t itemSize;
+        std::uint64_t size;
+        std::uint64_t capacity;
+        std::uint64_t clean;
+    };
+
+    void openMapping(const std::string& path, const std::size_t initialCapacity) {
+        struct stat status;
+        if (::fstat(fileDescriptor, &status) != 0) {
+            throw std::system_error(errno, std::generic_category(), "Cannot stat " + path);
+        }
+
+        if (status.st_size == 0) {
+            mappingSize = fileSize(initialCapacity);
+            resizeFile(mappingSize);
+            mapFile();
+            header()->magic = MAGIC;
+            header()->version = VERSION;
+            header()->itemSize = sizeof(T);
+            header()->size = 0;
+            header()->capacity = initialCapacity;
+            header()->clean = 0;
+            dirty = true;
+            return;
+        }
+
+        if (static_cast<std::size_t>(status.st_size) < sizeof(Header)) {
+            throw std::runtime_error("Not a priority queue file: " + path);
+        }
+
+        mappingSize = static_cast<std::size_t>(status.st_size);
+        mapFile();
+
+        const Header& existing = *header();
+        if (existing.magic != MAGIC || existing.version != VERSION || existing.itemSize != sizeof(T) ||
+                fileSize(existing.capacity) > mappingSize || existing.size > existing.capacity) {
+            throw std::runtime_error("Incompatible priority queue file: " + path);
+        }
+        if (existing.clean == 0) {
+            throw std::runtime_error("Priority queue file was not closed cleanly: " + path);
+        }
+        header()->clean = 0;
+        dirty = true;
+    }
+
+    static std::size_t fileSize(const std::size_t capacity) { return sizeof(Header) + capacity * sizeof(T); }
+
+    Header* header() { return static_cast<Header*>(mapping); }
+
+    const Header* header() const { return static_cast<const Header*>(mapping); }
+
+    // Keeps the header out of the items' accesses: only the first change after a sync() writes it.
+    void markDirty() {
+        if (!dirty && mapping != nullptr) {
+            header()->clean = 0;
+            dirty = true;
+        }
+    }
+
+    static bool unwinding() {
+#if __cplusplus >= 201703L
+        return std::uncaught_exceptions() > 0;
+#else
+        return std::uncaught_exception();
+#endif
+    }
+
+    void flush(const std::size_t length) {
+        if (::msync(mapping, length, MS_SYNC) != 0) {
+            throw std::system_error(errno, std::generic_category(), "Cannot sync the priority queue file");
+        }
+    }
+
+    void resizeFile(const std::size_t newSize) {
+        if (::ftruncate(fileDescriptor, static_cast<off_t>(newSize)) != 0) {
+            throw std::system_error(errno, std::generic_category(), "Cannot resize the priority queue file");
+        }
+    }
+
+    void mapFile() {
+        void* address = ::mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+        if (address == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "Cannot map the priority queue file");
+        }
+        mapping = address;
+    }
+
+    void release() {
+        if (mapping != nullptr) {
+            ::munmap(mapping, mappingSize);
+            mapping = nullptr;
+        }
+        if (fileDescriptor >= 0) {
+            ::close(fileDescriptor);
+            fileDescriptor = -1;
+        }
+    }
+
+    int fileDescriptor = -1;
+    void* mapping = nullptr;
+    std::size_t mappingSize = 0;
+    // The clean flag in the header is cleared.
+    bool dirty = false;
+};
+
+template <typename T>
+constexpr std::uint32_t MappedFileVector<T>::VERSION;
+
+template <typename T>
+constexpr std::uint64_t MappedFileVector<T>::MAGIC;
+
+} // namespace cserna
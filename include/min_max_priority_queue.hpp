@@ -0,0 +1,333 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "dynamic_priority_queue.hpp"
+
+namespace cserna {
+
+// What MinMaxPriorityQueue does when an item is pushed at MAX_CAPACITY.
+enum class OverflowPolicy {
+    // Throw std::overflow_error like DynamicPriorityQueue.
+    THROW,
+    // Drop the worst item, which is either the current maximum or the pushed item itself.
+    EVICT_WORST
+};
+
+// Double-ended priority queue implemented as a min-max heap: nodes on even levels are not greater than any item in
+// their subtree, nodes on odd levels are not smaller. Both the best (minimum) and the worst (maximum) item can be
+// accessed in O(1) and removed in O(log n), which makes it suitable for memory-bounded search that has to evict the
+// worst node when the queue is full.
+template <typename T,
+        typename IndexFunction,
+        typename ThreeWayComparator,
+        std::size_t INITIAL_CAPACITY = 0,
+        std::size_t MAX_CAPACITY = std::numeric_limits<std::size_t>::max(),
+        OverflowPolicy OVERFLOW_POLICY = OverflowPolicy::THROW,
+        typename IndexType = typename detail::IndexTypeOf<IndexFunction, T>::type>
+class MinMaxPriorityQueue {
+    static_assert(std::is_integral<IndexType>::value && std::is_unsigned<IndexType>::value,
+            "The index type must be an unsigned integer.");
+    static_assert(std::is_same<decltype(std::declval<IndexFunction&>()(std::declval<T&>())), IndexType&>::value,
+            "The index function must return a reference to IndexType.");
+
+public:
+    explicit MinMaxPriorityQueue(const ThreeWayComparator& comparator = ThreeWayComparator(),
+            IndexFunction indexFunction = IndexFunction())
+            : comparator{comparator}, indexFunction{std::move(indexFunction)}, queue{} {
+        queue.reserve(INITIAL_CAPACITY);
+        detail::reserveIndex(this->indexFunction, INITIAL_CAPACITY, 0);
+    }
+
+    ~MinMaxPriorityQueue() = default;
+    MinMaxPriorityQueue(const MinMaxPriorityQueue&) = delete;
+    MinMaxPriorityQueue(MinMaxPriorityQueue&&) noexcept = default;
+    MinMaxPriorityQueue& operator=(const MinMaxPriorityQueue&) = delete;
+    MinMaxPriorityQueue& operator=(MinMaxPriorityQueue&&) noexcept = default;
+
+    void push(T item) {
+        push(std::move(item), [](T&&) {});
+    }
+
+    // With the EVICT_WORST policy the evicted item (possibly the pushed item itself) is passed to evictAction, after
+    // its index has been invalidated.
+    template <typename EvictAction>
+    void push(T item, EvictAction evictAction) {
+        if (queue.size() == capacityLimit()) {
+            if (OVERFLOW_POLICY == OverflowPolicy::THROW) {
+                throw std::overflow_error(
+                        "Priority queue reached its maximum capacity:" + std::to_string(capacityLimit()));
+            }
+
+            if (queue.empty() || comparator(item, queue[maxIndex()]) >= 0) {
+                evictAction(std::move(item));
+                return;
+            }
+
+            evictAction(removeAt(maxIndex()));
+        }
+
+        const std::size_t index = queue.size();
+        indexFunction(item) = static_cast<IndexType>(index);
+        queue.push_back(std::move(item));
+        restore(index);
+    }
+
+    T popMin() {
+        if (queue.empty()) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return removeAt(0);
+    }
+
+    T popMax() {
+        if (queue.empty()) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return removeAt(maxIndex());
+    }
+
+    T pop() { return popMin(); }
+
+    T& topMin() {
+        if (queue.empty()) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return queue[0];
+    }
+
+    const T& topMin() const {
+        if (queue.empty()) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return queue[0];
+    }
+
+    T& topMax() {
+        if (queue.empty()) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return queue[maxIndex()];
+    }
+
+    const T& topMax() const {
+        if (queue.empty()) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return queue[maxIndex()];
+    }
+
+    T& top() { return topMin(); }
+
+    const T& top() const { return topMin(); }
+
+    void remove(T item) {
+        if (!contains(item)) {
+            return;
+        }
+
+        removeAt(indexFunction(item));
+    }
+
+    void clear() {
+        for (std::size_t i = 0; i < queue.size(); i++) {
+            invalidateIndex(queue[i]);
+        }
+        queue.clear();
+    }
+
+    void insertOrUpdate(T item) {
+        if (indexFunction(item) == std::numeric_limits<IndexType>::max()) {
+            push(std::move(item));
+        } else {
+            update(std::move(item));
+        }
+    }
+
+    void update(T item) {
+        const std::size_t index = indexFunction(item);
+        assert(index != std::numeric_limits<IndexType>::max() && "Cannot update a node that is not in the queue!");
+
+        restore(index);
+    }
+
+    template <typename Action>
+    void forEach(Action action = Action()) {
+        for (auto& item : queue) {
+            action(item);
+        }
+    }
+
+    std::size_t size() const { return queue.size(); }
+
+    bool empty() const { return queue.size() == 0; }
+
+    bool contains(const T& item) const { return indexFunction(item) != std::numeric_limits<IndexType>::max(); }
+
+private:
+    // Positions have to stay below the "not in queue" value of the index type.
+    static constexpr std::size_t capacityLimit() {
+        return MAX_CAPACITY < std::numeric_limits<IndexType>::max() ? MAX_CAPACITY
+                                                                    : std::numeric_limits<IndexType>::max();
+    }
+
+    static bool isMinLevel(std::size_t index) {
+        bool minLevel = true;
+        for (++index; index > 1; index /= 2) {
+            minLevel = !minLevel;
+        }
+        return minLevel;
+    }
+
+    static std::size_t parentOf(const std::size_t index) { return (index - 1) / 2; }
+
+    void invalidateIndex(T& item) { detail::invalidateIndex(indexFunction, item, 0); }
+
+    // The maximum is one of the children of the root (or the root itself).
+    std::size_t maxIndex() const {
+        if (queue.size() <= 2) {
+            return queue.size() - 1;
+        }
+
+        return comparator(queue[1], queue[2]) >= 0 ? 1 : 2;
+    }
+
+    // True if the item at lhs has to be above the item at rhs when both are on the given kind of level.
+    bool precedes(const std::size_t lhs, const std::size_t rhs, const bool minLevel) const {
+        const int comparison = comparator(queue[lhs], queue[rhs]);
+        return minLevel ? comparison < 0 : comparison > 0;
+    }
+
+    void swapItems(const std::size_t lhs, const std::size_t rhs) {
+        using std::swap;
+        swap(queue[lhs], queue[rhs]);
+        indexFunction(queue[lhs]) = static_cast<IndexType>(lhs);
+        indexFunction(queue[rhs]) = static_cast<IndexType>(rhs);
+    }
+
+    T removeAt(const std::size_t index) {
+        const std::size_t lastIndex = queue.size() - 1;
+
+        if (index != lastIndex) {
+            swapItems(index, lastIndex);
+        }
+
+        T item(std::move(queue[lastIndex]));
+        queue.pop_back();
+        invalidateIndex(item);
+
+        if (index < queue.size()) {
+            restore(index);
+        }
+
+        return item;
+    }
+
+    // Restores the heap property for an item that was placed at or changed at the given index.
+    void restore(const std::size_t index) {
+        if (index == 0) {
+            trickleDown(0);
+            return;
+        }
+
+        const bool minLevel = isMinLevel(index);
+        const std::size_t parentIndex = parentOf(index);
+
+        // The item belongs to the other kind of level: swap it with its parent. The former parent is extreme for the
+        // whole subtree on its own kind of level, so it only has to be checked against its new descendants.
+        if (precedes(parentIndex, index, minLevel)) {
+            swapItems(index, parentIndex);
+            trickleDown(index);
+            bubbleUp(parentIndex, !minLevel);
+            return;
+        }
+
+        if (!bubbleUp(index, minLevel)) {
+            trickleDown(index);
+        }
+    }
+
+    // Moves the item up along the grandparents on its own kind of level. Returns true if the item was moved.
+    bool bubbleUp(std::size_t index, const bool minLevel) {
+        bool moved = false;
+
+        while (index > 2) {
+            const std::size_t grandparentIndex = parentOf(parentOf(index));
+            if (!precedes(index, grandparentIndex, minLevel)) {
+                break;
+            }
+
+            swapItems(index, grandparentIndex);
+            index = grandparentIndex;
+            moved = true;
+        }
+
+        return moved;
+    }
+
+    void trickleDown(std::size_t index) {
+        const bool minLevel = isMinLevel(index);
+
+        while (true) {
+            // Find the most extreme among the children and grandchildren.
+            const std::size_t firstChild = index * 2 + 1;
+            if (firstChild >= queue.size()) {
+                return;
+            }
+
+            std::size_t extremeIndex = firstChild;
+            bool isGrandchild = false;
+
+            const std::size_t candidates[] = {firstChild + 1,
+                    firstChild * 2 + 1,
+                    firstChild * 2 + 2,
+                    (firstChild + 1) * 2 + 1,
+                    (firstChild + 1) * 2 + 2};
+
+            for (std::size_t i = 0; i < 5; ++i) {
+                const std::size_t candidate = candidates[i];
+                if (candidate < queue.size() && precedes(candidate, extremeIndex, minLevel)) {
+                    extremeIndex = candidate;
+                    isGrandchild = i > 0;
+                }
+            }
+
+            if (!precedes(extremeIndex, index, minLevel)) {
+                return;
+            }
+
+            swapItems(extremeIndex, index);
+
+            if (!isGrandchild) {
+                return;
+            }
+
+            // The item moved two levels down; it might now belong above its parent on the other kind of level.
+            const std::size_t parentIndex = parentOf(extremeIndex);
+            if (precedes(parentIndex, extremeIndex, minLevel)) {
+                swapItems(extremeIndex, parentIndex);
+            }
+
+            index = extremeIndex;
+        }
+    }
+
+    ThreeWayComparator comparator;
+    IndexFunction indexFunction;
+    std::vector<T> queue;
+};
+
+} // namespace cserna
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "dynamic_priority_queue.hpp"
+#include "spin_lock.hpp"
+
+namespace cserna {
+
+// Relaxed concurrent priority queue after Rihani, Sanders and Dementiev, "MultiQueues: Simple Relaxed Concurrent
+// Priority Queues" (2015), with the sticky queue selection of Williams and Sanders (2021). It consists of c * P
+// DynamicPriorityQueues, each behind a lock. Pushes and pops only ever try the locks and move on to another
+// sub-queue if one is busy. A pop locks two random sub-queues and takes the better of their tops, so it returns one of
+// the best O(c * P) items instead of the very best, but never waits on a busy lock. Threads work through a Handle,
+// which keeps its random state and sticks to the same sub-queues for a number of operations to keep them in its
+// cache. update() and remove() have to reach the one sub-queue that holds the item, so they wait for its lock.
+//
+// The sub-queue of every item is recorded by the queue id function, which maps a const item to a
+// std::atomic<std::size_t> stored with it (NOT_QUEUED if the item is not queued). With it update() and remove() find
+// and lock the right sub-queue from any thread. The index function is called concurrently for items of different
+// sub-queues, so it has to store the index in the item and declare `using is_intrusive = std::true_type;`.
+template <typename T,
+        typename IndexFunction,
+        typename ThreeWayComparator,
+        typename QueueIdFunction,
+        std::size_t ARITY = 2>
+class MultiQueue {
+    static_assert(detail::IsIntrusiveIndex<IndexFunction>::value,
+            "The index function must store the index in the items (is_intrusive) to be used concurrently.");
+    static_assert(std::is_same<decltype(std::declval<const QueueIdFunction&>()(std::declval<const T&>())),
+                          std::atomic<std::size_t>&>::value,
+            "The queue id function must return a reference to std::atomic<std::size_t>.");
+
+    using Queue = DynamicPriorityQueue<T,
+            IndexFunction,
+            ThreeWayComparator,
+            0,
+            std::numeric_limits<std::size_t>::max(),
+            ARITY>;
+
+    struct SubQueue {
+        SubQueue(const ThreeWayComparator& comparator, const IndexFunction& indexFunction)
+                : queue{comparator, indexFunction} {}
+
+        detail::SpinLock lock;
+        Queue queue;
+    };
+
+public:
+    static constexpr std::size_t NOT_QUEUED = std::numeric_limits<std::size_t>::max();
+
+    // Per-thread access to the queue. A handle must not be shared between threads.
+    class Handle {
+    public:
+        void push(T item) {
+            while (true) {
+                if (pushUses == 0) {
+                    pushQueue = randomQueue();
+                    pushUses = multiQueue->stickiness;
+                }
+
+                SubQueue& subQueue = *multiQueue->queues[pushQueue];
+                if (!subQueue.lock.try_lock()) {
+                    pushUses = 0;
+                    continue;
+                }
+
+                multiQueue->queueIdFunction(item).store(pushQueue, std::memory_order_relaxed);
+                subQueue.queue.push(std::move(item));
+                multiQueue->count.fetch_add(1, std::memory_order_relaxed);
+                subQueue.lock.unlock();
+
+                --pushUses;
+                return;
+            }
+        }
+
+        // Moves one of the best items to the output and returns true, or returns false if every sub-queue is empty.
+        bool tryPop(T& out) {
+            for (std::size_t attempt = 0; attempt < multiQueue->queues.size(); ++attempt) {
+                if (popUses == 0) {
+                    popQueues[0] = randomQueue();
+                    do {
+                        popQueues[1] = randomQueue();
+                    } while (popQueues[1] == popQueues[0]);
+                    popUses = multiQueue->stickiness;
+                }
+
+                SubQueue& first = *multiQueue->queues[popQueues[0]];
+                SubQueue& second = *multiQueue->queues[popQueues[1]];
+                if (!first.lock.try_lock()) {
+                    popUses = 0;
+                    continue;
+                }
+                if (!second.lock.try_lock()) {
+                    first.lock.unlock();
+                    popUses = 0;
+                    continue;
+                }
+
+                SubQueue* best = nullptr;
+                if (first.queue.empty()) {
+                    best = second.queue.empty() ? nullptr : &second;
+                } else if (second.queue.empty()) {
+                    best = &first;
+                } else {
+                    best = multiQueue->comparator(first.queue.top(), second.queue.top()) <= 0 ? &first : &second;
+                }
+
+                if (best != nullptr) {
+                    out = multiQueue->popFrom(*best);
+                }
+
+                second.lock.unlock();
+                first.lock.unlock();
+
+                if (best != nullptr) {
+                    --popUses;
+                    return true;
+                }
+
+                // Both are empty; the items are elsewhere.
+                popUses = 0;
+            }
+
+            // The random choices kept failing: look at every sub-queue before reporting an empty queue. A busy
+            // sub-queue may hold items, so the scan is repeated until it found every sub-queue unlocked.
+            while (true) {
+                bool skipped = false;
+                for (auto& subQueue : multiQueue->queues) {
+                    if (!subQueue->lock.try_lock()) {
+                        skipped = true;
+                        continue;
+                    }
+                    if (!subQueue->queue.empty()) {
+                        out = multiQueue->popFrom(*subQueue);
+                        subQueue->lock.unlock();
+                        return true;
+                    }
+                    subQueue->lock.unlock();
+                }
+
+                if (!skipped) {
+                    return false;
+                }
+                std::this_thread::yield();
+            }
+        }
+
+    private:
+        friend class MultiQueue;
+
+        Handle(MultiQueue* multiQueue, const unsigned seed) : multiQueue{multiQueue}, random{seed} {}
+
+        std::size_t randomQueue() { return random() % multiQueue->queues.size(); }
+
+        MultiQueue* multiQueue;
+        std::minstd_rand random;
+        std::size_t pushQueue = 0;
+        std::size_t pushUses = 0;
+        std::size_t popQueues[2] = {0, 0};
+        std::size_t popUses = 0;
+    };
+
+    // Creates queuesPerThread * threadCount sub-queues (at least two). Handles keep using the same sub-queues for
+    // stickiness operations, or until a lock is busy.
+    explicit MultiQueue(const std::size_t threadCount,
+            const std::size_t queuesPerThread = 2,
+            const std::size_t stickiness = 8,
+            const ThreeWayComparator& comparator = ThreeWayComparator(),
+            const IndexFunction& indexFunction = IndexFunction(),
+            const QueueIdFunction& queueIdFunction = QueueIdFunction())
+            : comparator{comparator},
+              queueIdFunction{queueIdFunction},
+              stickiness{stickiness > 0 ? stickiness : 1} {
+        const std::size_t queueCount = threadCount * queuesPerThread < 2 ? 2 : threadCount * queuesPerThread;
+        queues.reserve(queueCount);
+        for (std::size_t i = 0; i < queueCount; ++i) {
+            queues.emplace_back(new SubQueue(comparator, indexFunction));
+        }
+    }
+
+    ~MultiQueue() = default;
+    MultiQueue(const MultiQueue&) = delete;
+    MultiQueue(MultiQueue&&) = delete;
+    MultiQueue& operator=(const MultiQueue&) = delete;
+    MultiQueue& operator=(MultiQueue&&) = delete;
+
+    Handle handle(const unsigned seed) { return Handle(this, seed); }
+
+    // Applies change to the queued copy of the item in the sub-queue that holds it and moves the item to its new
+    // place. Other threads compare the items of a sub-queue while they hold its lock, so the key of a queued item may
+    // only change here. Returns false without calling change if the item is not queued.
+    template <typename Change>
+    bool update(T item, Change change) {
+        SubQueue* subQueue = lockSubQueueOf(item);
+        if (subQueue == nullptr) {
+            return false;
+        }
+
+        subQueue->queue.update(item, change);
+        subQueue->lock.unlock();
+        return true;
+    }
+
+    // Returns false if the item is not queued.
+    bool remove(T item) {
+        SubQueue* subQueue = lockSubQueueOf(item);
+        if (subQueue == nullptr) {
+            return false;
+        }
+
+        queueIdFunction(item).store(NOT_QUEUED, std::memory_order_relaxed);
+        subQueue->queue.remove(std::move(item));
+        count.fetch_sub(1, std::memory_order_relaxed);
+        subQueue->lock.unlock();
+        return true;
+    }
+
+    bool contains(const T& item) const {
+        return queueIdFunction(item).load(std::memory_order_acquire) != NOT_QUEUED;
+    }
+
+    // A snapshot that may be outdated as soon as it is returned.
+    std::size_t size() const { return count.load(std::memory_order_relaxed); }
+
+    bool empty() const { return size() == 0; }
+
+    std::size_t queueCount() const { return queues.size(); }
+
+private:
+    T popFrom(SubQueue& subQueue) {
+        T item = subQueue.queue.pop();
+        queueIdFunction(item).store(NOT_QUEUED, std::memory_order_relaxed);
+        count.fetch_sub(1, std::memory_order_relaxed);
+        return item;
+    }
+
+    // Locks the sub-queue that holds the item, or returns nullptr if the item is not queued. The item may move to
+    // another sub-queue until the lock is held, so the id is checked again.
+    SubQueue* lockSubQueueOf(T& item) {
+        while (true) {
+            const std::size_t id = queueIdFunction(item).load(std::memory_order_acquire);
+            if (id == NOT_QUEUED) {
+                return nullptr;
+            }
+
+            SubQueue* subQueue = queues[id].get();
+            subQueue->lock.lock();
+            if (queueIdFunction(item).load(std::memory_order_relaxed) == id) {
+                return subQueue;
+            }
+            subQueue->lock.unlock();
+        }
+    }
+
+    ThreeWayComparator comparator;
+    QueueIdFunction queueIdFunction;
+    std::size_t stickiness;
+    std::vector<std::unique_ptr<SubQueue>> queues;
+    std::atomic<std::size_t> count{0};
+};
+
+template <typename T,
+        typename IndexFunction,
+        typename ThreeWayComparator,
+        typename QueueIdFunction,
+        std::size_t ARITY>
+constexpr std::size_t MultiQueue<T, IndexFunction, ThreeWayComparator, QueueIdFunction, ARITY>::NOT_QUEUED;
+
+} // namespace cserna
@@ -0,0 +1,398 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "dynamic_priority_queue.hpp"
+
+namespace cserna {
+
+// Pairing heap engine with the same interface as DynamicPriorityQueue. Decrease-key is O(1) amortized: the node is
+// cut from its parent and linked with the root. The index function stores the handle of the node of each item, i.e.
+// its slot in the node pool, instead of an array position.
+template <typename T,
+        typename IndexFunction,
+        typename ThreeWayComparator,
+        std::size_t INITIAL_CAPACITY = 0,
+        std::size_t MAX_CAPACITY = std::numeric_limits<std::size_t>::max(),
+        typename IndexType = typename detail::IndexTypeOf<IndexFunction, T>::type>
+class PairingPriorityQueue {
+    static_assert(std::is_integral<IndexType>::value && std::is_unsigned<IndexType>::value,
+            "The index type must be an unsigned integer.");
+    static_assert(std::is_same<decltype(std::declval<IndexFunction&>()(std::declval<T&>())), IndexType&>::value,
+            "The index function must return a reference to IndexType.");
+
+public:
+    explicit PairingPriorityQueue(const ThreeWayComparator& comparator = ThreeWayComparator(),
+            IndexFunction indexFunction = IndexFunction())
+            : comparator{comparator}, indexFunction{std::move(indexFunction)}, nodes{}, freeNodes{}, siblings{} {
+        nodes.reserve(INITIAL_CAPACITY);
+        detail::reserveIndex(this->indexFunction, INITIAL_CAPACITY, 0);
+    }
+
+    ~PairingPriorityQueue() = default;
+    PairingPriorityQueue(const PairingPriorityQueue&) = delete;
+    PairingPriorityQueue(PairingPriorityQueue&&) noexcept = default;
+    PairingPriorityQueue& operator=(const PairingPriorityQueue&) = delete;
+    PairingPriorityQueue& operator=(PairingPriorityQueue&&) noexcept = default;
+
+    void push(T item) {
+        if (count == capacityLimit()) {
+            throw std::overflow_error("Priority queue reached its maximum capacity:" + std::to_string(capacityLimit()));
+        }
+
+        const IndexType node = allocate(std::move(item));
+        root = link(root, node);
+        ++count;
+    }
+
+    T pop() {
+        if (count == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        const IndexType oldRoot = root;
+        root = combineSiblings(nodes[oldRoot].child);
+        --count;
+
+        return release(oldRoot);
+    }
+
+    T& top() {
+        if (count == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return nodes[root].item;
+    }
+
+    const T& top() const {
+        if (count == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return nodes[root].item;
+    }
+
+    void remove(T item) {
+        if (!contains(item)) {
+            return;
+        }
+
+        const IndexType node = indexFunction(item);
+
+        if (node == root) {
+            pop();
+            return;
+        }
+
+        detach(node);
+        root = link(root, combineSiblings(nodes[node].child));
+        --count;
+
+        release(node);
+    }
+
+    void clear() {
+        forEachNode([this](IndexType node) { invalidateIndex(nodes[node].item); });
+
+        nodes.clear();
+        freeNodes.clear();
+        root = NIL;
+        count = 0;
+    }
+
+    void insertOrUpdate(T item) {
+        if (indexFunction(item) == NIL) {
+            push(std::move(item));
+        } else {
+            update(std::move(item));
+        }
+    }
+
+    void insertOrDecrease(T item) {
+        if (indexFunction(item) == NIL) {
+            push(std::move(item));
+        } else {
+            decreaseKey(std::move(item));
+        }
+    }
+
+    // The item got better: cut its subtree and link it with the root. O(1) amortized.
+    void decreaseKey(T item) {
+        const IndexType node = indexFunction(item);
+        assert(node != NIL && "Cannot update a node that is not in the queue!");
+
+        if (node == root) {
+            return;
+        }
+
+        detach(node);
+        root = link(root, node);
+    }
+
+    // The item got worse: its children might have to move above it, so it is reinserted as a single node.
+    void increaseKey(T item) {
+        const IndexType node = indexFunction(item);
+        assert(node != NIL && "Cannot update a node that is not in the queue!");
+
+        const IndexType children = nodes[node].child;
+        nodes[node].child = NIL;
+
+        if (node == root) {
+            root = link(combineSiblings(children), node);
+        } else {
+            detach(node);
+            root = link(link(root, combineSiblings(children)), node);
+        }
+    }
+
+    void update(T item) { increaseKey(std::move(item)); }
+
+    // Melds the other queue into this one. The node pool of the larger queue is kept and the nodes of the smaller one
+    // are relocated into it, after which the two roots are linked with a single comparison. With an intrusive index
+    // function (see detail::IsIntrusiveIndex) this costs O(min(n, m)), otherwise O(n + m). The other queue is left
+    // empty; its index function is told that the items left, as by clear().
+    void merge(PairingPriorityQueue&& other) {
+        if (other.count > capacityLimit() - count) {
+            throw std::overflow_error("Priority queue reached its maximum capacity:" + std::to_string(capacityLimit()));
+        }
+
+        const bool intrusive = detail::IsIntrusiveIndex<IndexFunction>::value;
+        const bool swapped = nodes.size() - freeNodes.size() < other.nodes.size() - other.freeNodes.size();
+
+        if (swapped) {
+            swapNodes(other);
+
+            // The items of the other queue keep their handles, which this queue's index function has to learn unless
+            // the handles are stored in the items.
+            if (!intrusive) {
+                forEachNode([this, &other](IndexType node) {
+                    detail::invalidateIndex(other.indexFunction, nodes[node].item, 0);
+                    indexFunction(nodes[node].item) = node;
+                });
+            }
+        }
+
+        if (other.root != NIL) {
+            // Allocate a slot for every node first, then translate the links.
+            // After a swap these are this queue's own items, which the other index function never held.
+            std::vector<IndexType> relocated(other.nodes.size(), NIL);
+            other.forEachNode([this, &other, &relocated, intrusive, swapped](IndexType node) {
+                if (!intrusive && !swapped) {
+                    other.invalidateIndex(other.nodes[node].item);
+                }
+                relocated[node] = allocate(std::move(other.nodes[node].item));
+            });
+
+            other.forEachNode([this, &other, &relocated](IndexType node) {
+                const Node& source = other.nodes[node];
+                Node& target = nodes[relocated[node]];
+
+                target.child = source.child == NIL ? NIL : relocated[source.child];
+                target.sibling = source.sibling == NIL ? NIL : relocated[source.sibling];
+                target.previous = source.previous == NIL ? NIL : relocated[source.previous];
+            });
+
+            root = link(root, relocated[other.root]);
+            count += other.count;
+        }
+
+        other.nodes.clear();
+        other.freeNodes.clear();
+        other.root = NIL;
+        other.count = 0;
+    }
+
+    template <typename Action>
+    void forEach(Action action = Action()) {
+        forEachNode([this, &action](IndexType node) { action(nodes[node].item); });
+    }
+
+    std::size_t size() const { return count; }
+
+    bool empty() const { return count == 0; }
+
+    bool contains(const T& item) const { return indexFunction(item) != NIL; }
+
+private:
+    static constexpr IndexType NIL = std::numeric_limits<IndexType>::max();
+
+    // Handles have to stay below the "not in queue" value of the index type.
+    static constexpr std::size_t capacityLimit() {
+        return MAX_CAPACITY < std::numeric_limits<IndexType>::max() ? MAX_CAPACITY
+                                                                    : std::numeric_limits<IndexType>::max();
+    }
+
+    struct Node {
+        explicit Node(T item) : item(std::move(item)) {}
+
+        T item;
+        IndexType child = NIL;
+        IndexType sibling = NIL;
+        // Parent for the leftmost child, left sibling otherwise.
+        IndexType previous = NIL;
+    };
+
+    void invalidateIndex(T& item) { detail::invalidateIndex(indexFunction, item, 0); }
+
+    void swapNodes(PairingPriorityQueue& other) {
+        nodes.swap(other.nodes);
+        freeNodes.swap(other.freeNodes);
+        std::swap(root, other.root);
+        std::swap(count, other.count);
+    }
+
+    IndexType allocate(T item) {
+        IndexType node;
+        if (freeNodes.empty()) {
+            node = static_cast<IndexType>(nodes.size());
+            nodes.emplace_back(std::move(item));
+        } else {
+            node = freeNodes.back();
+            freeNodes.pop_back();
+            nodes[node].item = std::move(item);
+        }
+
+        indexFunction(nodes[node].item) = node;
+        return node;
+    }
+
+    T release(const IndexType node) {
+        T item(std::move(nodes[node].item));
+        invalidateIndex(item);
+
+        nodes[node].child = NIL;
+        nodes[node].sibling = NIL;
+        nodes[node].previous = NIL;
+        freeNodes.push_back(node);
+
+        return item;
+    }
+
+    // Links two trees and returns the new root; the worse root becomes the leftmost child of the better one.
+    IndexType link(IndexType first, IndexType second) {
+        if (first == NIL) {
+            return second;
+        }
+        if (second == NIL) {
+            return first;
+        }
+
+        if (comparator(nodes[second].item, nodes[first].item) < 0) {
+            std::swap(first, second);
+        }
+
+        Node& parent = nodes[first];
+        Node& child = nodes[second];
+
+        child.sibling = parent.child;
+        if (parent.child != NIL) {
+            nodes[parent.child].previous = second;
+        }
+        child.previous = first;
+        parent.child = second;
+        parent.sibling = NIL;
+        parent.previous = NIL;
+
+        return first;
+    }
+
+    // Cuts the subtree of a non-root node from its parent.
+    void detach(const IndexType node) {
+        Node& current = nodes[node];
+        Node& previous = nodes[current.previous];
+
+        if (previous.child == node) {
+            previous.child = current.sibling;
+        } else {
+            previous.sibling = current.sibling;
+        }
+
+        if (current.sibling != NIL) {
+            nodes[current.sibling].previous = current.previous;
+        }
+
+        current.sibling = NIL;
+        current.previous = NIL;
+    }
+
+    // Standard two-pass pairing: link the siblings pairwise from left to right, then link the results from right
+    // to left.
+    IndexType combineSiblings(IndexType first) {
+        if (first == NIL) {
+            return NIL;
+        }
+
+        siblings.clear();
+        while (first != NIL) {
+            const IndexType second = nodes[first].sibling;
+            const IndexType next = second == NIL ? NIL : nodes[second].sibling;
+
+            nodes[first].sibling = NIL;
+            nodes[first].previous = NIL;
+            if (second != NIL) {
+                nodes[second].sibling = NIL;
+                nodes[second].previous = NIL;
+            }
+
+            siblings.push_back(link(first, second));
+            first = next;
+        }
+
+        IndexType result = siblings.back();
+        for (std::size_t i = siblings.size() - 1; i > 0; --i) {
+            result = link(siblings[i - 1], result);
+        }
+
+        return result;
+    }
+
+    template <typename NodeAction>
+    void forEachNode(NodeAction action) {
+        if (root == NIL) {
+            return;
+        }
+
+        std::vector<IndexType> stack{root};
+        while (!stack.empty()) {
+            const IndexType node = stack.back();
+            stack.pop_back();
+
+            if (nodes[node].sibling != NIL) {
+                stack.push_back(nodes[node].sibling);
+            }
+            if (nodes[node].child != NIL) {
+                stack.push_back(nodes[node].child);
+            }
+
+            action(node);
+        }
+    }
+
+    ThreeWayComparator comparator;
+    IndexFunction indexFunction;
+    std::vector<Node> nodes;
+    std::vector<IndexType> freeNodes;
+    // Scratch space of combineSiblings
+    std::vector<IndexType> siblings;
+    IndexType root = NIL;
+    std::size_t count = 0;
+};
+
+template <typename T,
+        typename IndexFunction,
+        typename ThreeWayComparator,
+        std::size_t INITIAL_CAPACITY,
+        std::size_t MAX_CAPACITY,
+        typename IndexType>
+constexpr IndexType
+        PairingPriorityQueue<T, IndexFunction, ThreeWayComparator, INITIAL_CAPACITY, MAX_CAPACITY, IndexType>::NIL;
+
+} // namespace cserna
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "dynamic_priority_queue.hpp"
+#include "keyed_dynamic_priority_queue.hpp"
+
+namespace cserna {
+
+// Radix heap for monotone unsigned integer keys, e.g. shortest path and uniform cost search, where a popped key is
+// never larger than any key pushed later. Items are kept in buckets by the highest bit in which their key differs
+// from the last popped key, so every item is moved at most once per bit of the key type. Keys are extracted by
+// KeyProjection and cached next to the items. Only pop() moves the base of the buckets to the new minimum; top() and
+// topKey() scan the first non-empty bucket instead, so every key not smaller than the last popped key can still be
+// pushed after a peek.
+//
+// The index function stores the bucket and the position of an item within its bucket.
+template <typename T,
+        typename IndexFunction,
+        typename KeyProjection,
+        std::size_t INITIAL_CAPACITY = 0,
+        std::size_t MAX_CAPACITY = std::numeric_limits<std::size_t>::max(),
+        typename IndexType = typename detail::IndexTypeOf<IndexFunction, T>::type>
+class RadixPriorityQueue {
+public:
+    using Key = typename ProjectedKey<T, KeyProjection>::type;
+
+private:
+    static_assert(std::is_integral<Key>::value && std::is_unsigned<Key>::value,
+            "The key of a radix heap must be an unsigned integer.");
+    static_assert(std::is_integral<IndexType>::value && std::is_unsigned<IndexType>::value,
+            "The index type must be an unsigned integer.");
+    static_assert(std::is_same<decltype(std::declval<IndexFunction&>()(std::declval<T&>())), IndexType&>::value,
+            "The index function must return a reference to IndexType.");
+
+    // Bucket 0 holds the keys equal to the last popped key, bucket b the keys whose highest differing bit is b - 1.
+    static constexpr std::size_t BUCKET_COUNT = std::numeric_limits<Key>::digits + 1;
+    static constexpr unsigned BUCKET_BITS = 8;
+    static_assert(BUCKET_COUNT <= (1u << BUCKET_BITS), "Too many buckets to encode in the index.");
+    static_assert(std::numeric_limits<IndexType>::digits > BUCKET_BITS, "The index type is too narrow.");
+
+public:
+    explicit RadixPriorityQueue(const KeyProjection& keyProjection = KeyProjection(),
+            IndexFunction indexFunction = IndexFunction())
+            : keyProjection{keyProjection}, indexFunction{std::move(indexFunction)}, buckets(BUCKET_COUNT) {
+        detail::reserveIndex(this->indexFunction, INITIAL_CAPACITY, 0);
+    }
+
+    ~RadixPriorityQueue() = default;
+    RadixPriorityQueue(const RadixPriorityQueue&) = delete;
+    RadixPriorityQueue(RadixPriorityQueue&&) noexcept = default;
+    RadixPriorityQueue& operator=(const RadixPriorityQueue&) = delete;
+    RadixPriorityQueue& operator=(RadixPriorityQueue&&) noexcept = default;
+
+    void push(T item) {
+        if (count == capacityLimit()) {
+            throw std::overflow_error("Priority queue reached its maximum capacity:" + std::to_string(capacityLimit()));
+        }
+
+        const Key key = keyProjection(item);
+        assert(key >= lastKey && "Radix heap keys must be monotone: key is smaller than the last popped key.");
+
+        insert(key, std::move(item));
+        ++count;
+    }
+
+    T pop() {
+        if (count == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        refill();
+
+        std::vector<Entry>& bucket = buckets[0];
+        T item(std::move(bucket.back().item));
+        bucket.pop_back();
+        --count;
+
+        invalidateIndex(item);
+        return item;
+    }
+
+    T& top() {
+        if (count == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return minimumEntry().item;
+    }
+
+    const T& top() const {
+        if (count == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return minimumEntry().item;
+    }
+
+    Key topKey() const {
+        if (count == 0) {
+            throw std::underflow_error("Priority queue is empty.");
+        }
+
+        return minimumEntry().key;
+    }
+
+    void remove(T item) {
+        if (!contains(item)) {
+            return;
+        }
+
+        const IndexType index = indexFunction(item);
+        invalidateIndex(item);
+        erase(index);
+        --count;
+    }
+
+    void clear() {
+        for (auto& bucket : buckets) {
+            for (auto& entry : bucket) {
+                invalidateIndex(entry.item);
+            }
+            bucket.clear();
+        }
+
+        count = 0;
+    }
+
+    void insertOrDecrease(T item) {
+        if (indexFunction(item) == std::numeric_limits<IndexType>::max()) {
+            push(std::move(item));
+        } else {
+            decreaseKey(std::move(item));
+        }
+    }
+
+    // The key of the item decreased, but it is still not smaller than the last popped key. The item replaces the
+    // queued copy, so with by-value items the caller's copy is the one that is kept.
+    void decreaseKey(T item) {
+        const IndexType index = indexFunction(item);
+        assert(index != std::numeric_limits<IndexType>::max() && "Cannot update a node that is not in the queue!");
+
+        const Key key = keyProjection(item);
+        assert(key >= lastKey && "Radix heap keys must be monotone: key is smaller than the last popped key.");
+        assert(key <= entryAt(index).key && "The key of the item increased.");
+
+        erase(index);
+        insert(key, std::move(item));
+    }
+
+    // Calls change on the queued copy of the item, which has to decrease its key, and moves it to its new bucket.
+    template <typename Change>
+    void decreaseKey(const T& item, Change change) {
+        const IndexType index = indexFunction(item);
+        assert(index != std::numeric_limits<IndexType>::max() && "Cannot update a node that is not in the queue!");
+
+        Entry& entry = entryAt(index);
+        change(entry.item);
+        const Key key = keyProjection(entry.item);
+        assert(key >= lastKey && "Radix heap keys must be monotone: key is smaller than the last popped key.");
+        assert(key <= entry.key && "The key of the item increased.");
+
+        T stored(erase(index));
+        insert(key, std::move(stored));
+    }
+
+    template <typename Action>
+    void forEach(Action action = Action()) {
+        for (auto& bucket : buckets) {
+            for (auto& entry : bucket) {
+                action(entry.item);
+            }
+        }
+    }
+
+    std::size_t size() const { return count; }
+
+    bool empty() const { return count == 0; }
+
+    bool contains(const T& item) const { return indexFunction(item) != std::numeric_limits<IndexType>::max(); }
+
+private:
+    struct Entry {
+        Entry(Key key, T item) : key(key), item(std::move(item)) {}
+
+        Key key;
+        T item;
+    };
+
+    // Indices are (position << BUCKET_BITS) | bucket and have to stay below the "not in queue" value.
+    static constexpr std::size_t capacityLimit() {
+        return MAX_CAPACITY < (std::numeric_limits<IndexType>::max() >> BUCKET_BITS)
+                ? MAX_CAPACITY
+                : (std::numeric_limits<IndexType>::max() >> BUCKET_BITS);
+    }
+
+    static IndexType encode(const std::size_t bucket, const std::size_t position) {
+        return static_cast<IndexType>((position << BUCKET_BITS) | bucket);
+    }
+
+    static std::size_t bucketOf(const IndexType index) { return index & ((1u << BUCKET_BITS) - 1); }
+
+    static std::size_t positionOf(const IndexType index) { return index >> BUCKET_BITS; }
+
+    // Number of significant bits of the value.
+    static std::size_t bitWidth(Key value) {
+        std::size_t width = 0;
+        while (value != 0) {
+            value >>= 1;
+            ++width;
+        }
+        return width;
+    }
+
+    std::size_t bucketFor(const Key key) const { return bitWidth(key ^ lastKey); }
+
+    void invalidateIndex(T& item) { detail::invalidateIndex(indexFunction, item, 0); }
+
+    Entry& entryAt(const IndexType index) { return buckets[bucketOf(index)][positionOf(index)]; }
+
+    // The entry pop() returns next: the last one of bucket 0, or the last entry with the smallest key of the first
+    // non-empty bucket, which refill() moves to the end of bucket 0.
+    const Entry& minimumEntry() const {
+        if (!buckets[0].empty()) {
+            return buckets[0].back();
+        }
+
+        std::size_t bucketIndex = 1;
+        while (buckets[bucketIndex].empty()) {
+            ++bucketIndex;
+        }
+
+        const std::vector<Entry>& bucket = buckets[bucketIndex];
+        std::size_t minimum = 0;
+        for (std::size_t position = 1; position < bucket.size(); ++position) {
+            if (bucket[position].key <= bucket[minimum].key) {
+                minimum = position;
+            }
+        }
+        return bucket[minimum];
+    }
+
+    Entry& minimumEntry() { return const_cast<Entry&>(static_cast<const RadixPriorityQueue&>(*this).minimumEntry()); }
+
+    void insert(const Key key, T item) {
+        const std::size_t bucketIndex = bucketFor(key);
+        std::vector<Entry>& bucket = buckets[bucketIndex];
+
+        indexFunction(item) = encode(bucketIndex, bucket.size());
+        bucket.emplace_back(key, std::move(item));
+    }
+
+    // Removes the entry at the index from its bucket by moving the last entry of the bucket into its place.
+    T erase(const IndexType index) {
+        std::vector<Entry>& bucket = buckets[bucketOf(index)];
+        const std::size_t position = positionOf(index);
+
+        T item(std::move(bucket[position].item));
+
+        if (position != bucket.size() - 1) {
+            bucket[position] = std::move(bucket.back());
+            indexFunction(bucket[position].item) = index;
+        }
+        bucket.pop_back();
+
+        return item;
+    }
+
+    // Makes sure that bucket 0 is not empty: the smallest key of the first non-empty bucket becomes the last key and
+    // the bucket is redistributed into the lower buckets.
+    void refill() {
+        if (!buckets[0].empty()) {
+            return;
+        }
+
+        std::size_t bucketIndex = 1;
+        while (buckets[bucketIndex].empty()) {
+            ++bucketIndex;
+        }
+
+        std::vector<Entry> bucket;
+        bucket.swap(buckets[bucketIndex]);
+
+        Key minimumKey = bucket[0].key;
+        for (const auto& entry : bucket) {
+            if (entry.key < minimumKey) {
+                minimumKey = entry.key;
+            }
+        }
+        lastKey = minimumKey;
+
+        for (auto& entry : bucket) {
+            insert(entry.key, std::move(entry.item));
+        }
+
+        // Reuse the allocation of the redistributed bucket.
+        bucket.clear();
+        buckets[bucketIndex].swap(bucket);
+    }
+
+    KeyProjection keyProjection;
+    IndexFunction indexFunction;
+    std::vector<std::vector<Entry>> buckets;
+    // The last popped key, which is also the base the buckets are relative to.
+    Key lastKey = 0;
+    std::size_t count = 0;
+};
+
+} // namespace cserna
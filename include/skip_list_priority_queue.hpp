@@ -0,0 +1,579 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace cserna {
+
+// Lock-free priority queue on a skiplist, after Lindén and Jonsson, "A Skiplist-Based Concurrent Priority Queue with
+// Minimal Memory Contention" (2013). A pop deletes the first node only logically, by marking the lowest bit of its
+// predecessor's level 0 pointer, so the deleted nodes form a prefix of the list. Only when that prefix is longer than
+// the bound offset does a pop unlink it, with a single CAS on the head, which keeps the pops from contending on the
+// head pointers. trySprayPop() is a relaxed pop after the SprayList of Alistarh, Kopinsky, Li and Shavit (2015): it
+// takes one of the first O(P log^3 P) items found by a random walk from the head instead of fighting over the first.
+//
+// The nodes hold copies of the items, which are never changed after the push. A key change is a reinsertion: the item
+// is pushed again with the new key, and the index function tells which of its nodes is current. The index function
+// maps a const item to a std::atomic<std::size_t> stored with it, e.g. in the object an item points to; the queue
+// writes a ticket of the current node into it, and NOT_QUEUED when the item leaves the queue. Pops skip the nodes of
+// outdated tickets.
+//
+// Unlinked nodes are reclaimed with epochs, as in the paper. Every operation that reads nodes announces the global
+// epoch in a record of its own, and the epoch only advances once every running operation has announced it. A node is
+// retired with the epoch in which it was unlinked and freed two epochs later, when no operation that could still
+// reach it is running. The number of retired nodes stays bounded while the queue is in use, unless an operation
+// stalls in the middle. The thread count also sets the number of records that are kept ready; more threads get
+// additional records.
+template <typename T, typename IndexFunction, typename ThreeWayComparator>
+class SkipListPriorityQueue {
+    static_assert(std::is_same<decltype(std::declval<const IndexFunction&>()(std::declval<const T&>())),
+                          std::atomic<std::size_t>&>::value,
+            "The index function must return a reference to std::atomic<std::size_t>.");
+
+public:
+    static constexpr std::size_t NOT_QUEUED = std::numeric_limits<std::size_t>::max();
+
+    // The thread count sets the reach of the spray walk; the bound offset is the length of the deleted prefix that
+    // is left in place before a pop unlinks it.
+    explicit SkipListPriorityQueue(const std::size_t threadCount = 1,
+            const std::size_t boundOffset = 32,
+            const ThreeWayComparator& comparator = ThreeWayComparator(),
+            const IndexFunction& indexFunction = IndexFunction())
+            : comparator{comparator},
+              indexFunction{indexFunction},
+              threadCount{threadCount > 0 ? threadCount : 1},
+              boundOffset{boundOffset},
+              sprayHeight{1},
+              head{new Node(T(), NOT_QUEUED, MAX_LEVEL)},
+              tail{new Node(T(), NOT_QUEUED, MAX_LEVEL)},
+              records{new Record[this->threadCount]} {
+        for (std::size_t threads = this->threadCount; threads > 1 && sprayHeight < MAX_LEVEL - 1; threads /= 2) {
+            ++sprayHeight;
+        }
+
+        head->inserting.store(false, std::memory_order_relaxed);
+        tail->inserting.store(false, std::memory_order_relaxed);
+        for (int level = 0; level < MAX_LEVEL; ++level) {
+            head->next[level].store(link(tail), std::memory_order_relaxed);
+        }
+    }
+
+    ~SkipListPriorityQueue() {
+        Node* node = pointer(head->next[0].load(std::memory_order_relaxed));
+        while (node != tail) {
+            Node* next = pointer(node->next[0].load(std::memory_order_relaxed));
+            delete node;
+            node = next;
+        }
+
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            freeRetired(records[i], std::numeric_limits<std::uint64_t>::max());
+        }
+        Record* record = extraRecords.load(std::memory_order_relaxed);
+        while (record != nullptr) {
+            Record* next = record->next;
+            freeRetired(*record, std::numeric_limits<std::uint64_t>::max());
+            delete record;
+            record = next;
+        }
+
+        delete head;
+        delete tail;
+    }
+
+    SkipListPriorityQueue(const SkipListPriorityQueue&) = delete;
+    SkipListPriorityQueue(SkipListPriorityQueue&&) = delete;
+    SkipListPriorityQueue& operator=(const SkipListPriorityQueue&) = delete;
+    SkipListPriorityQueue& operator=(SkipListPriorityQueue&&) = delete;
+
+    // Pushing an item that is already queued replaces its key.
+    void push(T item) {
+        const std::size_t ticket = nextTicket.fetch_add(1, std::memory_order_relaxed);
+        if (indexFunction(item).exchange(ticket) == NOT_QUEUED) {
+            count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Guard guard(*this);
+        insert(std::move(item), ticket);
+    }
+
+    // Moves the best item to the output and returns true, or returns false if the queue is empty.
+    bool tryPop(T& out) {
+        Guard guard(*this);
+        return popFirst(guard.record, out);
+    }
+
+    // Relaxed pop: moves one of the first items to the output. Falls back to tryPop() if the walk finds nothing.
+    bool trySprayPop(T& out) {
+        Guard guard(*this);
+
+        // Keep the front of the list free of sprayed items, which only a strict pop can unlink.
+        for (int i = 0; i < 2; ++i) {
+            if (deleteMin(guard.record, true) == nullptr) {
+                break;
+            }
+        }
+
+        // As in the SprayList, one pop in P is strict, so the first item cannot be passed over for long.
+        std::minstd_rand& random = threadRandom();
+        if (random() % threadCount == 0) {
+            return popFirst(guard.record, out);
+        }
+
+        Node* node = head;
+        for (int level = sprayHeight; level >= 0; --level) {
+            for (std::size_t jump = random() % (sprayHeight + 2); jump > 0; --jump) {
+                Node* next = pointer(node->next[level].load());
+                if (next == tail) {
+                    break;
+                }
+                node = next;
+            }
+        }
+
+        if (node == head) {
+            node = pointer(head->next[0].load());
+        }
+
+        for (; node != tail; node = pointer(node->next[0].load())) {
+            if (!node->taken.load(std::memory_order_relaxed) && claim(node)) {
+                out = node->item;
+                return true;
+            }
+        }
+
+        return popFirst(guard.record, out);
+    }
+
+    // Reinserts the item with its new key; the node with the old key is skipped when it comes up. Works for any
+    // change of the key. Returns false if the item is not queued.
+    bool update(T item) {
+        std::atomic<std::size_t>& index = indexFunction(item);
+        const std::size_t ticket = nextTicket.fetch_add(1, std::memory_order_relaxed);
+
+        std::size_t current = index.load();
+        do {
+            if (current == NOT_QUEUED) {
+                return false;
+            }
+        } while (!index.compare_exchange_weak(current, ticket));
+
+        Guard guard(*this);
+        insert(std::move(item), ticket);
+        return true;
+    }
+
+    bool decreaseKey(T item) { return update(std::move(item)); }
+
+    // Returns false if the item is not queued. Its node is skipped when it comes up.
+    bool remove(const T& item) {
+        std::atomic<std::size_t>& index = indexFunction(item);
+
+        std::size_t current = index.load();
+        do {
+            if (current == NOT_QUEUED) {
+                return false;
+            }
+        } while (!index.compare_exchange_weak(current, NOT_QUEUED));
+
+        count.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool contains(const T& item) const { return indexFunction(item).load() != NOT_QUEUED; }
+
+    // A snapshot that may be outdated as soon as it is returned.
+    std::size_t size() const { return count.load(std::memory_order_relaxed); }
+
+    bool empty() const { return size() == 0; }
+
+    // Frees the retired nodes that no operation can reach anymore, also those of records that are currently unused.
+    // Operations do this for their own record, so it is only needed to release memory after the threads stopped.
+    void collect() {
+        for (int round = 0; round < 2; ++round) {
+            tryAdvance();
+        }
+
+        const std::uint64_t epoch = globalEpoch.load();
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            collectRecord(records[i], epoch);
+        }
+        for (Record* record = extraRecords.load(); record != nullptr; record = record->next) {
+            collectRecord(*record, epoch);
+        }
+    }
+
+private:
+    static constexpr int MAX_LEVEL = 32;
+
+    struct Node {
+        Node(T item, const std::size_t ticket, const int height)
+                : item(std::move(item)), ticket{ticket}, height{height}, next{new std::atomic<std::uintptr_t>[height]} {
+            for (int level = 0; level < height; ++level) {
+                next[level].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        const T item;
+        const std::size_t ticket;
+        const int height;
+        // Level 0 carries the deletion mark of the successor in its lowest bit.
+        std::unique_ptr<std::atomic<std::uintptr_t>[]> next;
+        // Set by the pop that returns or discards the item.
+        std::atomic<bool> taken{false};
+        // Set until all levels are linked; the prefix is not unlinked beyond such a node.
+        std::atomic<bool> inserting{true};
+        Node* retiredNext = nullptr;
+    };
+
+    // Announces the epoch of an operation. The retired nodes are only touched by the operation that holds the record.
+    struct Record {
+        std::atomic<bool> active{false};
+        std::atomic<std::uint64_t> epoch{0};
+        // Nodes retired in an epoch, in the list of that epoch modulo 3.
+        Node* retired[3] = {nullptr, nullptr, nullptr};
+        std::uint64_t retiredEpoch[3] = {0, 0, 0};
+        Record* next = nullptr;
+        // Keeps the records of different threads off the same cache line.
+        char padding[64];
+    };
+
+    // Holds a record for the duration of an operation.
+    struct Guard {
+        explicit Guard(SkipListPriorityQueue& queue) : record(queue.enter()) {}
+
+        ~Guard() { record.active.store(false, std::memory_order_release); }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        Record& record;
+    };
+
+    static std::uintptr_t link(Node* node) { return reinterpret_cast<std::uintptr_t>(node); }
+
+    static Node* pointer(const std::uintptr_t link) { return reinterpret_cast<Node*>(link & ~std::uintptr_t{1}); }
+
+    static bool isMarked(const std::uintptr_t link) { return (link & 1) != 0; }
+
+    static std::minstd_rand& threadRandom() {
+        static thread_local std::minstd_rand random(
+                static_cast<std::minstd_rand::result_type>(std::hash<std::thread::id>()(std::this_thread::get_id())));
+        return random;
+    }
+
+    // The record this thread used last, so every thread usually finds its own record free on the first try.
+    static std::size_t& recordHint() {
+        static thread_local std::size_t hint = std::hash<std::thread::id>()(std::this_thread::get_id());
+        return hint;
+    }
+
+    static bool tryAcquire(Record& record) {
+        bool active = false;
+        return !record.active.load(std::memory_order_relaxed) && record.active.compare_exchange_strong(active, true);
+    }
+
+    Record& enter() {
+        Record* record = acquireRecord();
+
+        // The announcement has to be visible before any node is read.
+        const std::uint64_t epoch = globalEpoch.load();
+        record->epoch.store(epoch);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        freeRetired(*record, epoch);
+        return *record;
+    }
+
+    Record* acquireRecord() {
+        std::size_t& hint = recordHint();
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            const std::size_t index = (hint + i) % threadCount;
+            if (tryAcquire(records[index])) {
+                hint = index;
+                return &records[index];
+            }
+        }
+
+        for (Record* record = extraRecords.load(); record != nullptr; record = record->next) {
+            if (tryAcquire(*record)) {
+                return record;
+            }
+        }
+
+        // More threads than expected run at the same time. A new record blocks the epoch until it announces one.
+        Record* record = new Record();
+        record->active.store(true, std::memory_order_relaxed);
+        record->next = extraRecords.load();
+        while (!extraRecords.compare_exchange_weak(record->next, record)) {
+        }
+        return record;
+    }
+
+    // Advances the global epoch if every running operation has announced the current one.
+    void tryAdvance() {
+        std::uint64_t epoch = globalEpoch.load();
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            if (records[i].active.load() && records[i].epoch.load() != epoch) {
+                return;
+            }
+        }
+        for (Record* record = extraRecords.load(); record != nullptr; record = record->next) {
+            if (record->active.load() && record->epoch.load() != epoch) {
+                return;
+            }
+        }
+
+        globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+    }
+
+    // Frees the nodes of the record that were retired at least two epochs before the given one.
+    static void freeRetired(Record& record, const std::uint64_t epoch) {
+        for (int list = 0; list < 3; ++list) {
+            if (record.retired[list] != nullptr && epoch >= 2 && record.retiredEpoch[list] <= epoch - 2) {
+                freeList(record.retired[list]);
+                record.retired[list] = nullptr;
+            }
+        }
+    }
+
+    static void collectRecord(Record& record, const std::uint64_t epoch) {
+        if (tryAcquire(record)) {
+            freeRetired(record, epoch);
+            record.active.store(false, std::memory_order_release);
+        }
+    }
+
+    static void freeList(Node* node) {
+        while (node != nullptr) {
+            Node* next = node->retiredNext;
+            delete node;
+            node = next;
+        }
+    }
+
+    static int randomHeight() {
+        std::minstd_rand& random = threadRandom();
+        int height = 1;
+        while (height < MAX_LEVEL && random() % 2 == 0) {
+            ++height;
+        }
+        return height;
+    }
+
+    // Takes a deleted node for this pop; fails if another pop took it or the item was pushed again since.
+    bool claim(Node* node) {
+        if (node->taken.exchange(true)) {
+            return false;
+        }
+
+        std::size_t ticket = node->ticket;
+        if (!indexFunction(node->item).compare_exchange_strong(ticket, NOT_QUEUED)) {
+            return false;
+        }
+
+        count.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Finds the predecessors and successors of the position of the item on every level, behind all deleted nodes.
+    // Returns the last deleted node passed on level 0.
+    Node* locatePredecessors(const T& item, Node** predecessors, Node** successors) {
+        Node* deleted = nullptr;
+        Node* node = head;
+
+        for (int level = MAX_LEVEL - 1; level >= 0; --level) {
+            std::uintptr_t next = node->next[level].load();
+            bool nextDeleted = isMarked(next);
+            Node* current = pointer(next);
+
+            while ((current != tail && (comparator(current->item, item) < 0 || isMarked(current->next[0].load()))) ||
+                    (level == 0 && nextDeleted)) {
+                if (level == 0 && nextDeleted) {
+                    deleted = current;
+                }
+
+                node = current;
+                next = node->next[level].load();
+                nextDeleted = isMarked(next);
+                current = pointer(next);
+            }
+
+            predecessors[level] = node;
+            successors[level] = current;
+        }
+
+        return deleted;
+    }
+
+    void insert(T item, const std::size_t ticket) {
+        const int height = randomHeight();
+        Node* node = new Node(std::move(item), ticket, height);
+
+        Node* predecessors[MAX_LEVEL];
+        Node* successors[MAX_LEVEL];
+        Node* deleted;
+
+        while (true) {
+            deleted = locatePredecessors(node->item, predecessors, successors);
+            node->next[0].store(link(successors[0]), std::memory_order_relaxed);
+
+            std::uintptr_t expected = link(successors[0]);
+            if (predecessors[0]->next[0].compare_exchange_strong(expected, link(node))) {
+                break;
+            }
+        }
+
+        // The upper levels are only shortcuts; give up on them once the node or its successor is deleted.
+        for (int level = 1; level < height;) {
+            node->next[level].store(link(successors[level]));
+            if (isMarked(node->next[0].load()) || isMarked(successors[level]->next[0].load()) ||
+                    deleted == successors[level]) {
+                break;
+            }
+
+            std::uintptr_t expected = link(successors[level]);
+            if (predecessors[level]->next[level].compare_exchange_strong(expected, link(node))) {
+                ++level;
+            } else {
+                deleted = locatePredecessors(node->item, predecessors, successors);
+                if (successors[0] != node) {
+                    break;
+                }
+            }
+        }
+
+        node->inserting.store(false);
+    }
+
+    bool popFirst(Record& record, T& out) {
+        while (Node* node = deleteMin(record, false)) {
+            if (claim(node)) {
+                out = node->item;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Logically deletes the first node that is not deleted yet and returns it, or returns nullptr if the list is
+    // empty. With onlyTaken the node is only deleted if a spray pop already took it.
+    Node* deleteMin(Record& record, const bool onlyTaken) {
+        Node* node = head;
+        const std::uintptr_t observedHead = head->next[0].load();
+        Node* newHead = nullptr;
+        std::size_t offset = 0;
+        std::uintptr_t next;
+
+        do {
+            ++offset;
+            next = node->next[0].load();
+            if (pointer(next) == tail) {
+                return nullptr;
+            }
+
+            if (newHead == nullptr && node->inserting.load()) {
+                newHead = node;
+            }
+
+            if (!isMarked(next)) {
+                if (onlyTaken && !pointer(next)->taken.load()) {
+                    return nullptr;
+                }
+                next = node->next[0].fetch_or(1);
+            }
+
+            node = pointer(next);
+        } while (isMarked(next));
+
+        if (newHead == nullptr) {
+            newHead = node;
+        }
+
+        // Unlink the deleted prefix up to the new head in one step.
+        std::uintptr_t expected = observedHead;
+        if (offset > boundOffset && head->next[0].load() == observedHead &&
+                head->next[0].compare_exchange_strong(expected, link(newHead) | 1)) {
+            restructure();
+
+            Node* current = pointer(observedHead);
+            while (current != newHead) {
+                Node* following = pointer(current->next[0].load());
+                retire(record, current);
+                current = following;
+            }
+            tryAdvance();
+        }
+
+        return node;
+    }
+
+    // Moves the head pointers of the upper levels past the deleted prefix.
+    void restructure() {
+        Node* predecessor = head;
+
+        for (int level = MAX_LEVEL - 1; level > 0;) {
+            std::uintptr_t first = head->next[level].load();
+            if (!isMarked(pointer(first)->next[0].load())) {
+                --level;
+                continue;
+            }
+
+            Node* current = pointer(predecessor->next[level].load());
+            while (isMarked(current->next[0].load())) {
+                predecessor = current;
+                current = pointer(predecessor->next[level].load());
+            }
+
+            if (head->next[level].compare_exchange_strong(first, predecessor->next[level].load())) {
+                --level;
+            }
+        }
+    }
+
+    // Operations that started before the unlink may still read the node, so it is filed under the epoch read after.
+    void retire(Record& record, Node* node) {
+        const std::uint64_t epoch = globalEpoch.load();
+        const int list = static_cast<int>(epoch % 3);
+        if (record.retiredEpoch[list] != epoch) {
+            // Filed at least three epochs ago.
+            freeList(record.retired[list]);
+            record.retired[list] = nullptr;
+            record.retiredEpoch[list] = epoch;
+        }
+
+        node->retiredNext = record.retired[list];
+        record.retired[list] = node;
+    }
+
+    ThreeWayComparator comparator;
+    IndexFunction indexFunction;
+    std::size_t threadCount;
+    std::size_t boundOffset;
+    int sprayHeight;
+    Node* head;
+    Node* tail;
+    std::unique_ptr<Record[]> records;
+    // Records for threads beyond the thread count, freed with the queue.
+    std::atomic<Record*> extraRecords{nullptr};
+    std::atomic<std::uint64_t> globalEpoch{0};
+    std::atomic<std::size_t> nextTicket{0};
+    std::atomic<std::size_t> count{0};
+};
+
+template <typename T, typename IndexFunction, typename ThreeWayComparator>
+constexpr std::size_t SkipListPriorityQueue<T, IndexFunction, ThreeWayComparator>::NOT_QUEUED;
+
+template <typename T, typename IndexFunction, typename ThreeWayComparator>
+constexpr int SkipListPriorityQueue<T, IndexFunction, ThreeWayComparator>::MAX_LEVEL;
+
+} // namespace cserna
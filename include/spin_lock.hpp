@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace cserna {
+
+namespace detail {
+
+// Test-and-test-and-set lock, small enough to give every heap node its own.
+class SpinLock {
+public:
+    void lock() {
+        while (locked.exchange(true, std::memory_order_acquire)) {
+            while (locked.load(std::memory_order_relaxed)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    bool try_lock() {
+        return !locked.load(std::memory_order_relaxed) && !locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() { locked.store(false, std::memory_order_release); }
+
+private:
+    std::atomic<bool> locked{false};
+};
+
+// Reader-writer spin lock with writer preference: a waiting writer blocks new readers.
+class SharedSpinLock {
+public:
+    void lock_shared() {
+        while (true) {
+            std::uint32_t current = state.load(std::memory_order_relaxed);
+            if ((current & WRITER) == 0 &&
+                    state.compare_exchange_weak(current, current + 1, std::memory_order_acquire)) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void unlock_shared() { state.fetch_sub(1, std::memory_order_release); }
+
+    void lock() {
+        while (true) {
+            std::uint32_t current = state.load(std::memory_order_relaxed);
+            if ((current & WRITER) == 0 &&
+                    state.compare_exchange_weak(current, current | WRITER, std::memory_order_acquire)) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+
+        // Wait for the readers that got in before the writer bit was set.
+        while (state.load(std::memory_order_acquire) != WRITER) {
+            std::this_thread::yield();
+        }
+    }
+
+    void unlock() { state.store(0, std::memory_order_release); }
+
+private:
+    static constexpr std::uint32_t WRITER = std::uint32_t{1} << 31;
+
+    std::atomic<std::uint32_t> state{0};
+};
+
+} // namespace detail
+
+} // namespace cserna
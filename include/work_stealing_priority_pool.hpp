@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "dynamic_priority_queue.hpp"
+#include "spin_lock.hpp"
+
+namespace cserna {
+
+// One DynamicPriorityQueue per worker thread, as in hash-distributed parallel A* (HDA*): any thread pushes an item to
+// the worker that owns it, and every worker pops from its own queue. A worker whose queue runs dry steals a batch of
+// the best items from the worker with the best item. Every rebalancePeriod pops it also checks whether another worker
+// holds a better item than its own best one and steals a batch if so, which keeps the search close to best-first.
+//
+// Every worker publishes the key of its best item, as given by the key function (e.g. the f-value of a search node),
+// so lowerBound() returns the best key in the pool without taking any lock, e.g. to check whether an incumbent
+// solution is proven optimal. Items move between queues, so the index function has to store the index in the items and
+// declare `using is_intrusive = std::true_type;`.
+template <typename T,
+        typename IndexFunction,
+        typename ThreeWayComparator,
+        typename KeyFunction,
+        std::size_t ARITY = 2>
+class WorkStealingPriorityPool {
+    static_assert(detail::IsIntrusiveIndex<IndexFunction>::value,
+            "The index function must store the index in the items (is_intrusive) to be used concurrently.");
+
+    using Queue = DynamicPriorityQueue<T,
+            IndexFunction,
+            ThreeWayComparator,
+            0,
+            std::numeric_limits<std::size_t>::max(),
+            ARITY>;
+
+public:
+    using Key = typename std::decay<decltype(std::declval<const KeyFunction&>()(std::declval<const T&>()))>::type;
+
+    // Key published by a worker without items.
+    static constexpr Key emptyKey() {
+        return std::numeric_limits<Key>::has_infinity ? std::numeric_limits<Key>::infinity()
+                                                      : std::numeric_limits<Key>::max();
+    }
+
+private:
+    struct Worker {
+        Worker(const ThreeWayComparator& comparator, const IndexFunction& indexFunction)
+                : queue{comparator, indexFunction} {}
+
+        detail::SpinLock lock;
+        Queue queue;
+        std::atomic<Key> bestKey{emptyKey()};
+        std::atomic<std::size_t> size{0};
+        // Only used by the owner thread
+        std::size_t popsSinceRebalance = 0;
+        std::vector<T> batch;
+    };
+
+public:
+    // A steal takes up to stealBatch items, but never more than half of the victim's items. A rebalancePeriod of 0
+    // only steals when a worker runs dry.
+    explicit WorkStealingPriorityPool(const std::size_t workerCount,
+            const std::size_t stealBatch = 32,
+            const std::size_t rebalancePeriod = 64,
+            const ThreeWayComparator& comparator = ThreeWayComparator(),
+            const IndexFunction& indexFunction = IndexFunction(),
+            const KeyFunction& keyFunction = KeyFunction())
+            : keyFunction{keyFunction},
+              stealBatch{stealBatch > 0 ? stealBatch : 1},
+              rebalancePeriod{rebalancePeriod} {
+        const std::size_t count = workerCount > 0 ? workerCount : 1;
+        workers.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            workers.emplace_back(new Worker(comparator, indexFunction));
+        }
+    }
+
+    ~WorkStealingPriorityPool() = default;
+    WorkStealingPriorityPool(const WorkStealingPriorityPool&) = delete;
+    WorkStealingPriorityPool(WorkStealingPriorityPool&&) = delete;
+    WorkStealingPriorityPool& operator=(const WorkStealingPriorityPool&) = delete;
+    WorkStealingPriorityPool& operator=(WorkStealingPriorityPool&&) = delete;
+
+    // Thread-safe; any thread may push to any worker.
+    void push(const std::size_t worker, T item) {
+        Worker& target = *workers[worker];
+        target.lock.lock();
+        target.queue.push(std::move(item));
+        publish(target);
+        target.lock.unlock();
+    }
+
+    // Called by the owner of the worker only. Moves the best local item to the output and returns true, stealing
+    // first if the worker ran dry or it is time to rebalance. Returns false if every queue is empty.
+    bool tryPop(const std::size_t worker, T& out) {
+        Worker& self = *workers[worker];
+
+        if (rebalancePeriod > 0 && ++self.popsSinceRebalance >= rebalancePeriod) {
+            self.popsSinceRebalance = 0;
+            const std::size_t victim = bestVictim(worker);
+            if (victim != worker && workers[victim]->bestKey.load() < self.bestKey.load()) {
+                stealFrom(worker, victim);
+            }
+        }
+
+        while (true) {
+            self.lock.lock();
+            if (!self.queue.empty()) {
+                out = self.queue.pop();
+                publish(self);
+                self.lock.unlock();
+                return true;
+            }
+            self.lock.unlock();
+
+            if (!steal(worker)) {
+                return false;
+            }
+        }
+    }
+
+    // Called by the owner of the worker only. Moves a batch of the best items of the worker with the best item to
+    // this worker; returns false if no other worker has items.
+    bool steal(const std::size_t worker) {
+        for (std::size_t attempt = 0; attempt < workers.size(); ++attempt) {
+            const std::size_t victim = bestVictim(worker);
+            if (victim == worker) {
+                return false;
+            }
+
+            if (stealFrom(worker, victim)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // The best key in the pool, or emptyKey() if the pool is empty. Items that were popped and are still being
+    // processed are not counted. Retries while a steal moves items between queues.
+    Key lowerBound() const {
+        while (true) {
+            const std::size_t started = stealsStarted.load();
+            if (stealsFinished.load() != started) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            Key best = emptyKey();
+            for (const auto& worker : workers) {
+                best = std::min(best, worker->bestKey.load());
+            }
+
+            if (stealsStarted.load() == started) {
+                return best;
+            }
+        }
+    }
+
+    // A snapshot that may be outdated as soon as it is returned.
+    std::size_t size() const {
+        std::size_t total = 0;
+        for (const auto& worker : workers) {
+            total += worker->size.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    // A snapshot of the size of one worker's queue.
+    std::size_t size(const std::size_t worker) const { return workers[worker]->size.load(std::memory_order_relaxed); }
+
+    std::size_t workerCount() const { return workers.size(); }
+
+private:
+    // The worker with the best published key other than the given one, or the given one if all others are empty.
+    std::size_t bestVictim(const std::size_t worker) const {
+        std::size_t victim = worker;
+        for (std::size_t i = 0; i < workers.size(); ++i) {
+            if (i == worker || workers[i]->size.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+
+            if (victim == worker || workers[i]->bestKey.load() < workers[victim]->bestKey.load()) {
+                victim = i;
+            }
+        }
+
+        return victim;
+    }
+
+    bool stealFrom(const std::size_t worker, const std::size_t victim) {
+        Worker& self = *workers[worker];
+        Worker& from = *workers[victim];
+
+        // Lock in index order, so two workers stealing from each other cannot deadlock.
+        Worker& first = worker < victim ? self : from;
+        Worker& second = worker < victim ? from : self;
+        first.lock.lock();
+        second.lock.lock();
+        stealsStarted.fetch_add(1);
+
+        const std::size_t count = std::min(stealBatch, (from.queue.size() + 1) / 2);
+        self.batch.clear();
+        from.queue.popBatch(count, std::back_inserter(self.batch));
+        self.queue.pushBulk(std::make_move_iterator(self.batch.begin()), std::make_move_iterator(self.batch.end()));
+        publish(from);
+        publish(self);
+
+        stealsFinished.fetch_add(1);
+        second.lock.unlock();
+        first.lock.unlock();
+
+        return count > 0;
+    }
+
+    // Called with the worker's lock held.
+    void publish(Worker& worker) {
+        worker.bestKey.store(worker.queue.empty() ? emptyKey() : keyFunction(worker.queue.top()));
+        worker.size.store(worker.queue.size(), std::memory_order_relaxed);
+    }
+
+    KeyFunction keyFunction;
+    std::size_t stealBatch;
+    std::size_t rebalancePeriod;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<std::size_t> stealsStarted{0};
+    std::atomic<std::size_t> stealsFinished{0};
+};
+
+} // namespace cserna
@@ -0,0 +1,152 @@
+#include "catch.hpp"
+
+#include <random>
+
+#include "../include/bucket_priority_queue.hpp"
+
+namespace cserna {
+namespace {
+
+struct TestItem {
+    explicit TestItem(int value) : value(value) {}
+
+    int value;
+    std::size_t index = std::numeric_limits<std::size_t>::max();
+};
+
+struct IndexFunction {
+    std::size_t& operator()(TestItem* item) { return item->index; }
+    std::size_t operator()(const TestItem* item) const { return item->index; }
+};
+
+struct ValueProjection {
+    int operator()(const TestItem* item) const { return item->value; }
+};
+
+TEST_CASE("BucketPriorityQueue tie breaking test", "[BucketPriorityQueue]") {
+    auto node0 = TestItem(1);
+    auto node1 = TestItem(1);
+    auto node2 = TestItem(0);
+
+    SECTION("LIFO") {
+        BucketPriorityQueue<TestItem*, IndexFunction, ValueProjection> queue;
+        queue.push(&node0);
+        queue.push(&node1);
+        queue.push(&node2);
+
+        REQUIRE(queue.topKey() == 0);
+        REQUIRE(queue.pop() == &node2);
+        REQUIRE(queue.pop() == &node1);
+        REQUIRE(queue.pop() == &node0);
+    }
+
+    SECTION("FIFO") {
+        BucketPriorityQueue<TestItem*, IndexFunction, ValueProjection, BucketTieBreaking::FIFO> queue;
+        queue.push(&node0);
+        queue.push(&node1);
+        queue.push(&node2);
+
+        REQUIRE(queue.pop() == &node2);
+        REQUIRE(queue.pop() == &node0);
+        REQUIRE(queue.pop() == &node1);
+    }
+}
+
+TEST_CASE("BucketPriorityQueue update/remove test", "[BucketPriorityQueue]") {
+    BucketPriorityQueue<TestItem*, IndexFunction, ValueProjection, BucketTieBreaking::FIFO> queue;
+
+    REQUIRE(queue.empty());
+    REQUIRE_THROWS_AS(queue.pop(), std::underflow_error);
+    REQUIRE_THROWS_AS(queue.top(), std::underflow_error);
+
+    constexpr int size = 2000;
+    std::mt19937 random(3);
+
+    std::vector<TestItem> items;
+    items.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back(static_cast<int>(random() % 300));
+    }
+
+    for (auto& item : items) {
+        queue.push(&item);
+    }
+
+    for (int i = 0; i < size; ++i) {
+        TestItem& item = items[random() % size];
+        if (random() % 3 == 0) {
+            queue.remove(&item);
+            REQUIRE(!queue.contains(&item));
+        } else {
+            item.value = static_cast<int>(random() % 300);
+            queue.insertOrUpdate(&item);
+            REQUIRE(queue.contains(&item));
+        }
+
+        if (i % 10 == 0) {
+            const int top = queue.top()->value;
+            REQUIRE(queue.topKey() == top);
+            for (auto& other : items) {
+                if (queue.contains(&other)) {
+                    REQUIRE(other.value >= top);
+                }
+            }
+        }
+    }
+
+    int value = 0;
+    while (!queue.empty()) {
+        REQUIRE(queue.top()->value >= value);
+        value = queue.pop()->value;
+    }
+
+    for (auto& item : items) {
+        REQUIRE(!queue.contains(&item));
+    }
+}
+
+TEST_CASE("BucketPriorityQueue large key offset test", "[BucketPriorityQueue]") {
+    // Absolute indexing would need a billion buckets for these keys.
+    constexpr int offset = 1000000000;
+    constexpr int size = 1000;
+    std::mt19937 random(5);
+
+    std::vector<TestItem> items;
+    items.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back(0);
+    }
+
+    BucketPriorityQueue<TestItem*, IndexFunction, ValueProjection> queue;
+
+    // Dijkstra-like: every pushed key is at most 50 above the last popped one, and some are below the top.
+    int value = offset;
+    std::size_t next = 0;
+    while (next < items.size() || !queue.empty()) {
+        for (int i = 0; i < 3 && next < items.size(); ++i) {
+            items[next].value = value - 10 + static_cast<int>(random() % 60);
+            queue.push(&items[next++]);
+        }
+
+        if (random() % 4 == 0 && next > 0) {
+            TestItem& item = items[random() % next];
+            if (queue.contains(&item)) {
+                item.value = value + static_cast<int>(random() % 50);
+                queue.update(&item);
+            }
+        }
+
+        const int top = queue.topKey();
+        for (std::size_t i = 0; i < next; ++i) {
+            if (queue.contains(&items[i])) {
+                REQUIRE(items[i].value >= top);
+            }
+        }
+
+        REQUIRE(queue.pop()->value == top);
+        value = top;
+    }
+}
+
+} // namespace
+} // namespace cserna
@@ -0,0 +1,267 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <thread>
+
+#include "../include/concurrent_dynamic_priority_queue.hpp"
+
+namespace cserna {
+namespace {
+
+struct TestItem {
+    explicit TestItem(int value) : value(value) {}
+
+    int value;
+    std::size_t index = std::numeric_limits<std::size_t>::max();
+};
+
+struct IndexFunction {
+    using is_intrusive = std::true_type;
+
+    std::size_t& operator()(TestItem* item) { return item->index; }
+    std::size_t operator()(const TestItem* item) const { return item->index; }
+};
+
+struct ItemCompare {
+    int operator()(const TestItem* lhs, const TestItem* rhs) const {
+        if (lhs->value < rhs->value)
+            return -1;
+        if (lhs->value > rhs->value)
+            return 1;
+        return 0;
+    }
+};
+
+using Queue = ConcurrentDynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare>;
+
+constexpr int threadCount = 4;
+
+std::vector<TestItem> makeItems(const int size) {
+    std::vector<TestItem> items;
+    items.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back((i * 7919) % size);
+    }
+    return items;
+}
+
+TEST_CASE("ConcurrentDynamicPriorityQueue sequential test", "[ConcurrentDynamicPriorityQueue]") {
+    Queue queue;
+    REQUIRE(queue.empty());
+    REQUIRE_THROWS_AS(queue.pop(), std::underflow_error);
+
+    constexpr int size = 1000;
+    std::mt19937 random(17);
+
+    std::vector<TestItem> items;
+    items.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back(static_cast<int>(random() % 10000));
+    }
+
+    for (auto& item : items) {
+        queue.push(&item);
+    }
+    REQUIRE(queue.size() == size);
+
+    for (int i = 0; i < size; ++i) {
+        TestItem& item = items[random() % size];
+        if (random() % 4 == 0) {
+            queue.remove(&item);
+            REQUIRE(!queue.contains(&item));
+        } else if (queue.contains(&item)) {
+            const int value = static_cast<int>(random() % 10000);
+            queue.update(&item, [value](TestItem* changed) { changed->value = value; });
+        }
+    }
+
+    int value = std::numeric_limits<int>::min();
+    while (!queue.empty()) {
+        TestItem* item = queue.pop();
+        REQUIRE(item->value >= value);
+        REQUIRE(!queue.contains(item));
+        value = item->value;
+    }
+
+    TestItem item(0);
+    queue.push(&item);
+    queue.clear();
+    REQUIRE(queue.empty());
+    REQUIRE(!queue.contains(&item));
+}
+
+// Keeps the position in 32 bits, as a search with many nodes does to save memory.
+struct NarrowItem {
+    int value;
+    std::uint32_t index;
+};
+
+struct NarrowIndexFunction {
+    using is_intrusive = std::true_type;
+
+    std::uint32_t& operator()(NarrowItem* item) { return item->index; }
+    std::uint32_t operator()(const NarrowItem* item) const { return item->index; }
+};
+
+struct NarrowItemCompare {
+    int operator()(const NarrowItem* lhs, const NarrowItem* rhs) const {
+        if (lhs->value < rhs->value)
+            return -1;
+        if (lhs->value > rhs->value)
+            return 1;
+        return 0;
+    }
+};
+
+TEST_CASE("ConcurrentDynamicPriorityQueue narrow index update test", "[ConcurrentDynamicPriorityQueue]") {
+    ConcurrentDynamicPriorityQueue<NarrowItem*, NarrowIndexFunction, NarrowItemCompare> queue;
+
+    constexpr std::uint32_t notQueued = std::numeric_limits<std::uint32_t>::max();
+    std::vector<NarrowItem> items;
+    for (int i = 0; i < 100; ++i) {
+        items.push_back(NarrowItem{i, notQueued});
+    }
+    for (int i = 0; i < 100; i += 2) {
+        queue.push(&items[i]);
+    }
+
+    bool called = false;
+    REQUIRE(!queue.update(&items[1], [&called](NarrowItem*) { called = true; }));
+    REQUIRE(!called);
+    REQUIRE(!queue.contains(&items[1]));
+    REQUIRE(!queue.remove(&items[1]));
+    REQUIRE(queue.size() == 50);
+
+    REQUIRE(queue.update(&items[98], [](NarrowItem* changed) { changed->value = -1; }));
+    REQUIRE(queue.remove(&items[0]));
+    REQUIRE(queue.pop() == &items[98]);
+    REQUIRE(items[98].index == notQueued);
+
+    int value = std::numeric_limits<int>::min();
+    while (!queue.empty()) {
+        NarrowItem* item = queue.pop();
+        REQUIRE(item->value >= value);
+        value = item->value;
+    }
+}
+
+TEST_CASE("ConcurrentDynamicPriorityQueue overflow test", "[ConcurrentDynamicPriorityQueue]") {
+    ConcurrentDynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, 2, 2> queue;
+
+    auto node0 = TestItem(0);
+    auto node1 = TestItem(1);
+    auto node2 = TestItem(2);
+
+    queue.push(&node0);
+    queue.push(&node1);
+    REQUIRE_THROWS_AS(queue.push(&node2), std::overflow_error);
+}
+
+TEST_CASE("ConcurrentDynamicPriorityQueue parallel push/pop test", "[ConcurrentDynamicPriorityQueue]") {
+    constexpr int perThread = 5000;
+    auto items = makeItems(threadCount * perThread);
+
+    Queue queue;
+
+    // Pushes race with pops, and the first pushes have to grow the heap.
+    std::vector<std::vector<TestItem*>> popped(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&queue, &items, &popped, t]() {
+            for (int i = 0; i < perThread; ++i) {
+                queue.push(&items[t * perThread + i]);
+
+                TestItem* item;
+                if (i % 2 == 0 && queue.tryPop(item)) {
+                    popped[t].push_back(item);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<TestItem*> all;
+    for (auto& items : popped) {
+        all.insert(all.end(), items.begin(), items.end());
+    }
+
+    int value = std::numeric_limits<int>::min();
+    while (!queue.empty()) {
+        TestItem* item = queue.pop();
+        REQUIRE(item->value >= value);
+        value = item->value;
+        all.push_back(item);
+    }
+
+    REQUIRE(all.size() == items.size());
+    std::sort(all.begin(), all.end());
+    REQUIRE(std::unique(all.begin(), all.end()) == all.end());
+    for (auto& item : items) {
+        REQUIRE(!queue.contains(&item));
+    }
+}
+
+TEST_CASE("ConcurrentDynamicPriorityQueue parallel update test", "[ConcurrentDynamicPriorityQueue]") {
+    constexpr int perThread = 2000;
+    std::vector<TestItem> items;
+    items.reserve(threadCount * perThread);
+    for (int i = 0; i < threadCount * perThread; ++i) {
+        items.emplace_back(i);
+    }
+
+    Queue queue;
+    for (auto& item : items) {
+        queue.push(&item);
+    }
+
+    // Every thread owns a disjoint set of items, so no item is touched by two threads at once.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&queue, &items, t]() {
+            std::mt19937 random(static_cast<unsigned>(t));
+            for (int i = 0; i < perThread; ++i) {
+                TestItem* item = &items[t * perThread + i];
+                switch (random() % 3) {
+                case 0: {
+                    const int value = static_cast<int>(random() % 100000);
+                    queue.update(item, [value](TestItem* changed) { changed->value = value; });
+                    break;
+                }
+                case 1:
+                    queue.remove(item);
+                    break;
+                default:
+                    queue.remove(item);
+                    item->value = static_cast<int>(random() % 100000);
+                    queue.push(item);
+                    break;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::size_t expected = 0;
+    for (auto& item : items) {
+        if (queue.contains(&item)) {
+            ++expected;
+        }
+    }
+    REQUIRE(queue.size() == expected);
+
+    int value = std::numeric_limits<int>::min();
+    while (!queue.empty()) {
+        TestItem* item = queue.pop();
+        REQUIRE(item->value >= value);
+        value = item->value;
+    }
+}
+
+} // namespace
+} // namespace cserna
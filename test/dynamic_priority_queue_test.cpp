@@ -1,6 +1,8 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 
+#include <memory>
+
 #include "../include/dynamic_priority_queue.hpp"
 
 namespace cserna {
@@ -14,6 +16,8 @@ struct TestItem {
 };
 
 struct IndexFunction {
+    using is_intrusive = std::true_type;
+
     std::size_t& operator()(TestItem* testNode) { return testNode->index; }
     std::size_t operator()(const TestItem* testNode) const { return testNode->index; }
 };
@@ -46,6 +50,17 @@ struct NodeEqual {
     bool operator()(const TestItem& lhs, const TestItem& rhs) const { return lhs.value == rhs.value; }
 };
 
+int scatteredValue(const int i, const int size) { return (i * 7919) % size; }
+
+std::vector<TestItem> makeItems(const int size) {
+    std::vector<TestItem> items;
+    items.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back(scatteredValue(i, size));
+    }
+    return items;
+}
+
 TEST_CASE("IndexFunctionTest", "[DynamicPriorityQueue]") {
     // Index function example
 
@@ -271,6 +286,596 @@ TEST_CASE("NonIntrusiveIndexFunction contains test", "[DynamicPriorityQueue]") {
     queue.contains(node1);
 }
 
+TEST_CASE("DynamicPriorityQueue update increase test", "[DynamicPriorityQueue]") {
+    DynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, 100, 100> queue;
+
+    auto node0 = TestItem(0);
+    auto node1 = TestItem(1);
+    auto node2 = TestItem(2);
+
+    queue.push(&node0);
+    queue.push(&node1);
+    queue.push(&node2);
+
+    node0.value = 3;
+    queue.update(&node0);
+
+    REQUIRE(queue.pop() == &node1);
+    REQUIRE(queue.pop() == &node2);
+    REQUIRE(queue.pop() == &node0);
+}
+
+TEST_CASE("DynamicPriorityQueue decrease/increase key test", "[DynamicPriorityQueue]") {
+    DynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, 100, 100> queue;
+
+    auto node0 = TestItem(0);
+    auto node1 = TestItem(1);
+    auto node2 = TestItem(2);
+    auto node3 = TestItem(3);
+
+    queue.push(&node0);
+    queue.push(&node1);
+    queue.push(&node2);
+
+    node2.value = -1;
+    queue.decreaseKey(&node2);
+    REQUIRE(node2.index == 0);
+    REQUIRE(queue.top() == &node2);
+
+    node2.value = 5;
+    queue.increaseKey(&node2);
+    REQUIRE(queue.top() == &node0);
+
+    queue.insertOrDecrease(&node3);
+    REQUIRE(queue.contains(&node3));
+    REQUIRE(queue.size() == 4);
+
+    node3.value = -2;
+    queue.insertOrDecrease(&node3);
+    REQUIRE(queue.size() == 4);
+    REQUIRE(node3.index == 0);
+
+    REQUIRE(queue.pop() == &node3);
+    REQUIRE(queue.pop() == &node0);
+    REQUIRE(queue.pop() == &node1);
+    REQUIRE(queue.pop() == &node2);
+}
+
+TEST_CASE("DynamicPriorityQueue replaceTop/pushPop test", "[DynamicPriorityQueue]") {
+    DynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, 100, 100> queue;
+
+    auto node0 = TestItem(0);
+    auto node1 = TestItem(1);
+    auto node2 = TestItem(2);
+    auto node3 = TestItem(3);
+    auto node4 = TestItem(-1);
+
+    REQUIRE_THROWS_AS(queue.replaceTop(&node0), std::underflow_error);
+    REQUIRE(queue.pushPop(&node0) == &node0);
+    REQUIRE(queue.empty());
+
+    queue.push(&node0);
+    queue.push(&node1);
+    queue.push(&node2);
+
+    REQUIRE(queue.replaceTop(&node3) == &node0);
+    REQUIRE(node0.index == std::numeric_limits<std::size_t>::max());
+    REQUIRE(queue.size() == 3);
+    REQUIRE(queue.contains(&node3));
+    REQUIRE(queue.top() == &node1);
+
+    // Better than the top: returned without entering the queue
+    REQUIRE(queue.pushPop(&node4) == &node4);
+    REQUIRE(node4.index == std::numeric_limits<std::size_t>::max());
+
+    REQUIRE(queue.pushPop(&node0) == &node0);
+    REQUIRE(queue.size() == 3);
+
+    node0.value = 4;
+    REQUIRE(queue.pushPop(&node0) == &node1);
+    REQUIRE(node1.index == std::numeric_limits<std::size_t>::max());
+
+    REQUIRE(queue.pop() == &node2);
+    REQUIRE(queue.pop() == &node3);
+    REQUIRE(queue.pop() == &node0);
+}
+
+template <std::size_t ARITY, bool BOTTOM_UP_POP = false>
+void testArity() {
+    constexpr int size = 1000;
+    DynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, size, size, ARITY, BOTTOM_UP_POP> queue;
+
+    auto items = makeItems(size);
+
+    for (auto& item : items) {
+        queue.push(&item);
+    }
+
+    for (int i = 0; i < size; i += 3) {
+        items[i].value = -items[i].value;
+        queue.update(&items[i]);
+    }
+
+    for (int i = 1; i < size; i += 5) {
+        queue.remove(&items[i]);
+        REQUIRE(items[i].index == std::numeric_limits<std::size_t>::max());
+    }
+
+    int value = std::numeric_limits<int>::min();
+    while (!queue.empty()) {
+        REQUIRE(queue.top()->index == 0);
+        REQUIRE(queue.top()->value >= value);
+        value = queue.pop()->value;
+    }
+}
+
+TEST_CASE("DynamicPriorityQueue arity test", "[DynamicPriorityQueue]") {
+    testArity<2>();
+    testArity<3>();
+    testArity<4>();
+    testArity<8>();
+}
+
+TEST_CASE("DynamicPriorityQueue bulk build test", "[DynamicPriorityQueue]") {
+    constexpr int size = 1000;
+    auto items = makeItems(size);
+
+    std::vector<TestItem*> pointers;
+    for (auto& item : items) {
+        pointers.push_back(&item);
+    }
+
+    SECTION("Range constructor") {
+        DynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, 0, size, 4> queue(pointers.begin(), pointers.end());
+
+        REQUIRE(queue.size() == size);
+        for (int i = 0; i < size; ++i) {
+            REQUIRE(queue.top()->index == 0);
+            REQUIRE(queue.pop()->value == i);
+        }
+    }
+
+    SECTION("Push bulk into non-empty queue") {
+        DynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, 0, size> queue;
+
+        queue.push(pointers[0]);
+        // Large batch is heapified, small batch is sifted up
+        queue.pushBulk(pointers.begin() + 1, pointers.begin() + 990);
+        queue.pushBulk(pointers.begin() + 990, pointers.end());
+
+        REQUIRE(queue.size() == size);
+        for (auto& item : items) {
+            REQUIRE(queue.contains(&item));
+        }
+
+        items[size - 1].value = -1;
+        queue.update(&items[size - 1]);
+        REQUIRE(queue.pop() == &items[size - 1]);
+
+        for (int i = 0; i < size; ++i) {
+            if (i == scatteredValue(size - 1, size)) {
+                continue;
+            }
+            REQUIRE(queue.pop()->value == i);
+        }
+        REQUIRE(queue.empty());
+    }
+
+    SECTION("Push bulk over capacity") {
+        DynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, 0, 10> queue;
+
+        REQUIRE_THROWS_AS(queue.pushBulk(pointers.begin(), pointers.begin() + 11), std::overflow_error);
+        REQUIRE(queue.empty());
+    }
+}
+
+TEST_CASE("DynamicPriorityQueue update batch test", "[DynamicPriorityQueue]") {
+    constexpr int size = 1000;
+    auto items = makeItems(size);
+
+    std::vector<TestItem*> pointers;
+    for (auto& item : items) {
+        pointers.push_back(&item);
+    }
+
+    DynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, 0, size> queue(pointers.begin(), pointers.end());
+    REQUIRE(queue.getRebuildRatio() == 0.1);
+
+    SECTION("Small batch is sifted") {
+        std::vector<TestItem*> changed(pointers.begin(), pointers.begin() + 10);
+        for (auto item : changed) {
+            item->value = size - item->value;
+        }
+        queue.updateBatch(changed.begin(), changed.end());
+    }
+
+    SECTION("Large batch is rebuilt") {
+        queue.setRebuildRatio(0.01);
+        std::vector<TestItem*> changed(pointers.begin(), pointers.begin() + 500);
+        for (auto item : changed) {
+            item->value = size - item->value;
+        }
+        queue.updateBatch(changed.begin(), changed.end());
+    }
+
+    int value = std::numeric_limits<int>::min();
+    while (!queue.empty()) {
+        REQUIRE(queue.top()->index == 0);
+        REQUIRE(queue.top()->value >= value);
+        value = queue.pop()->value;
+    }
+}
+
+TEST_CASE("DynamicPriorityQueue merge test", "[DynamicPriorityQueue]") {
+    constexpr int size = 1000;
+    auto items = makeItems(size);
+
+    using Queue = DynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, 0, size, 4>;
+    Queue small;
+    Queue large;
+
+    for (int i = 0; i < size; ++i) {
+        if (i % 10 == 0) {
+            small.push(&items[i]);
+        } else {
+            large.push(&items[i]);
+        }
+    }
+
+    SECTION("Merge larger into smaller") {
+        small.merge(std::move(large));
+        REQUIRE(large.empty());
+
+        for (int i = 0; i < size; ++i) {
+            REQUIRE(small.top()->index == 0);
+            REQUIRE(small.pop()->value == i);
+        }
+    }
+
+    SECTION("Merge smaller into larger") {
+        large.merge(std::move(small));
+        REQUIRE(small.empty());
+
+        for (int i = 0; i < size; ++i) {
+            REQUIRE(large.top()->index == 0);
+            REQUIRE(large.pop()->value == i);
+        }
+    }
+
+    SECTION("Merge over capacity") {
+        Queue other;
+        auto extra = TestItem(-1);
+        other.push(&extra);
+
+        large.merge(std::move(small));
+        REQUIRE_THROWS_AS(large.merge(std::move(other)), std::overflow_error);
+        REQUIRE(other.size() == 1);
+    }
+}
+
+TEST_CASE("NonIntrusiveIndexFunction merge test", "[DynamicPriorityQueue]") {
+    using Queue =
+            DynamicPriorityQueue<TestItem, NonIntrusiveIndexFunction<TestItem, NodeHash, NodeEqual>, NodeCompareRef>;
+    Queue first;
+    Queue second;
+
+    for (int i = 0; i < 100; ++i) {
+        if (i % 3 == 0) {
+            first.push(TestItem(i));
+        } else {
+            second.push(TestItem(i));
+        }
+    }
+
+    first.merge(std::move(second));
+    REQUIRE(!second.contains(TestItem(1)));
+
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(first.contains(TestItem(i)));
+    }
+
+    first.remove(TestItem(50));
+
+    for (int i = 0; i < 100; ++i) {
+        if (i != 50) {
+            REQUIRE(first.pop().value == i);
+        }
+    }
+}
+
+// Has no default constructor, so the index function using it has to be passed in.
+struct OffsetIdProjection {
+    explicit OffsetIdProjection(const int offset) : offset(offset) {}
+
+    std::uint32_t operator()(const TestItem& item) const { return static_cast<std::uint32_t>(item.value - offset); }
+
+    int offset;
+};
+
+TEST_CASE("DenseIdIndexFunction merge test", "[DynamicPriorityQueue]") {
+    using Index = DenseIdIndexFunction<TestItem, OffsetIdProjection>;
+    using Queue = DynamicPriorityQueue<TestItem, Index, NodeCompareRef>;
+
+    Queue small(NodeCompareRef(), Index(OffsetIdProjection(100)));
+    Queue large(NodeCompareRef(), Index(OffsetIdProjection(100)));
+    Queue tiny(NodeCompareRef(), Index(OffsetIdProjection(100)));
+    for (int i = 100; i < 200; ++i) {
+        if (i % 4 == 0) {
+            small.push(TestItem(i));
+        } else if (i != 199) {
+            large.push(TestItem(i));
+        }
+    }
+    tiny.push(TestItem(199));
+
+    // The larger queue's items stay in place, the smaller one's are appended.
+    small.merge(std::move(large));
+    small.merge(std::move(tiny));
+    REQUIRE(small.size() == 100);
+    REQUIRE(!large.contains(TestItem(101)));
+    REQUIRE(!tiny.contains(TestItem(199)));
+
+    // The emptied queues keep their index functions.
+    large.push(TestItem(150));
+    REQUIRE(large.contains(TestItem(150)));
+    REQUIRE(large.pop().value == 150);
+
+    small.remove(TestItem(150));
+    for (int i = 100; i < 200; ++i) {
+        if (i != 150) {
+            REQUIRE(small.contains(TestItem(i)));
+            REQUIRE(small.pop().value == i);
+        }
+    }
+}
+
+TEST_CASE("DynamicPriorityQueue topK/orderedSnapshot test", "[DynamicPriorityQueue]") {
+    constexpr int size = 1000;
+    auto items = makeItems(size);
+
+    DynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, 0, size, 3> queue;
+    for (auto& item : items) {
+        queue.push(&item);
+    }
+
+    std::vector<std::size_t> indices;
+    for (auto& item : items) {
+        indices.push_back(item.index);
+    }
+
+    std::vector<TestItem*> best;
+    queue.topK(10, std::back_inserter(best));
+    REQUIRE(best.size() == 10);
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE(best[i]->value == i);
+    }
+
+    std::vector<TestItem*> all;
+    queue.topK(2 * size, std::back_inserter(all));
+    REQUIRE(all.size() == size);
+
+    const std::vector<TestItem*> snapshot = queue.orderedSnapshot();
+    REQUIRE(snapshot.size() == size);
+    for (int i = 0; i < size; ++i) {
+        REQUIRE(all[i]->value == i);
+        REQUIRE(snapshot[i]->value == i);
+    }
+
+    // Neither the queue nor the indices changed
+    REQUIRE(queue.size() == size);
+    for (int i = 0; i < size; ++i) {
+        REQUIRE(items[i].index == indices[i]);
+    }
+}
+
+TEST_CASE("DynamicPriorityQueue popBatch test", "[DynamicPriorityQueue]") {
+    constexpr int size = 1000;
+    auto items = makeItems(size);
+
+    DynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, 0, size> queue;
+    for (auto& item : items) {
+        queue.push(&item);
+    }
+
+    std::vector<TestItem*> batch;
+
+    // Small batch is popped one by one
+    queue.popBatch(5, std::back_inserter(batch));
+    // Large batch is cut out and the rest is rebuilt
+    queue.popBatch(495, std::back_inserter(batch));
+
+    REQUIRE(batch.size() == 500);
+    REQUIRE(queue.size() == 500);
+    for (int i = 0; i < 500; ++i) {
+        REQUIRE(batch[i]->value == i);
+        REQUIRE(!queue.contains(batch[i]));
+    }
+
+    for (int i = 500; i < size; ++i) {
+        REQUIRE(queue.top()->index == 0);
+        REQUIRE(queue.pop()->value == i);
+    }
+
+    batch.clear();
+    queue.popBatch(10, std::back_inserter(batch));
+    REQUIRE(batch.empty());
+}
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    explicit CountingAllocator(std::size_t* allocations) : allocations(allocations) {}
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) : allocations(other.allocations) {}
+
+    T* allocate(std::size_t count) {
+        ++*allocations;
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T* pointer, std::size_t count) { std::allocator<T>().deallocate(pointer, count); }
+
+    std::size_t* allocations;
+};
+
+template <typename T, typename U>
+bool operator==(const CountingAllocator<T>& lhs, const CountingAllocator<U>& rhs) {
+    return lhs.allocations == rhs.allocations;
+}
+
+template <typename T, typename U>
+bool operator!=(const CountingAllocator<T>& lhs, const CountingAllocator<U>& rhs) {
+    return !(lhs == rhs);
+}
+
+TEST_CASE("DynamicPriorityQueue allocator test", "[DynamicPriorityQueue]") {
+    using Storage = std::vector<TestItem*, CountingAllocator<TestItem*>>;
+    using Queue = DynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, 16, 100, 2, false, std::size_t, Storage>;
+
+    std::size_t allocations = 0;
+    const CountingAllocator<TestItem*> allocator(&allocations);
+    Queue queue{ItemCompare(), IndexFunction(), Storage(allocator)};
+    REQUIRE(allocations == 1);
+
+    std::vector<TestItem> items;
+    items.reserve(16);
+    for (int i = 0; i < 16; ++i) {
+        items.emplace_back(15 - i);
+    }
+
+    for (auto& item : items) {
+        queue.push(&item);
+    }
+    REQUIRE(allocations == 1);
+
+    for (int i = 0; i < 16; ++i) {
+        REQUIRE(queue.pop()->value == i);
+    }
+}
+
+TEST_CASE("NonIntrusiveIndexFunction bulk build test", "[DynamicPriorityQueue]") {
+    std::vector<TestItem> items;
+    for (int i = 0; i < 100; ++i) {
+        items.emplace_back(99 - i);
+    }
+
+    DynamicPriorityQueue<TestItem, NonIntrusiveIndexFunction<TestItem, NodeHash, NodeEqual>, NodeCompareRef, 100, 100>
+            queue(items.begin(), items.end());
+
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(queue.contains(TestItem(i)));
+    }
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(queue.pop().value == i);
+    }
+}
+
+struct ItemIdProjection {
+    std::uint32_t operator()(const TestItem& item) const { return static_cast<std::uint32_t>(item.value); }
+};
+
+TEST_CASE("DenseIdIndexFunction test", "[DynamicPriorityQueue]") {
+    DynamicPriorityQueue<TestItem, DenseIdIndexFunction<TestItem, ItemIdProjection>, NodeCompareRef, 10, 100> queue;
+
+    REQUIRE(!queue.contains(TestItem(1000)));
+
+    for (int i = 99; i >= 0; --i) {
+        queue.push(TestItem(i));
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(queue.contains(TestItem(i)));
+    }
+
+    queue.remove(TestItem(50));
+    REQUIRE(!queue.contains(TestItem(50)));
+
+    for (int i = 0; i < 100; ++i) {
+        if (i == 50) {
+            continue;
+        }
+        REQUIRE(queue.pop().value == i);
+        REQUIRE(!queue.contains(TestItem(i)));
+    }
+}
+
+template <typename Index>
+struct NarrowIndexItem {
+    explicit NarrowIndexItem(int value) : value(value) {}
+
+    int value;
+    Index index = std::numeric_limits<Index>::max();
+};
+
+template <typename Index>
+struct NarrowIndexFunction {
+    Index& operator()(NarrowIndexItem<Index>* item) { return item->index; }
+    Index operator()(const NarrowIndexItem<Index>* item) const { return item->index; }
+};
+
+template <typename Index>
+struct NarrowIndexCompare {
+    int operator()(const NarrowIndexItem<Index>* lhs, const NarrowIndexItem<Index>* rhs) const {
+        return lhs->value < rhs->value ? -1 : (lhs->value > rhs->value ? 1 : 0);
+    }
+};
+
+TEST_CASE("DynamicPriorityQueue index type test", "[DynamicPriorityQueue]") {
+    SECTION("32 bit indices") {
+        using Item = NarrowIndexItem<std::uint32_t>;
+        DynamicPriorityQueue<Item*, NarrowIndexFunction<std::uint32_t>, NarrowIndexCompare<std::uint32_t>> queue;
+
+        std::vector<Item> items;
+        for (int i = 0; i < 100; ++i) {
+            items.emplace_back(99 - i);
+        }
+        for (auto& item : items) {
+            queue.push(&item);
+        }
+
+        queue.remove(&items[0]);
+        REQUIRE(items[0].index == std::numeric_limits<std::uint32_t>::max());
+        REQUIRE(!queue.contains(&items[0]));
+
+        for (int i = 0; i < 99; ++i) {
+            REQUIRE(queue.top()->index == 0);
+            REQUIRE(queue.pop()->value == i);
+        }
+    }
+
+    SECTION("Capacity is limited by the index type") {
+        using Item = NarrowIndexItem<std::uint8_t>;
+        DynamicPriorityQueue<Item*, NarrowIndexFunction<std::uint8_t>, NarrowIndexCompare<std::uint8_t>> queue;
+
+        std::vector<Item> items;
+        for (int i = 0; i < 256; ++i) {
+            items.emplace_back(i);
+        }
+
+        // Index 255 is the "not in queue" value
+        for (int i = 0; i < 255; ++i) {
+            queue.push(&items[i]);
+        }
+        REQUIRE_THROWS_AS(queue.push(&items[255]), std::overflow_error);
+        std::vector<Item*> overflow{&items[255]};
+        REQUIRE_THROWS_AS(queue.pushBulk(overflow.begin(), overflow.end()), std::overflow_error);
+    }
+
+    SECTION("Non-intrusive 32 bit indices") {
+        DynamicPriorityQueue<TestItem,
+                NonIntrusiveIndexFunction<TestItem, NodeHash, NodeEqual, std::uint32_t>,
+                NodeCompareRef>
+                queue;
+
+        queue.push(TestItem(1));
+        queue.push(TestItem(0));
+        REQUIRE(queue.contains(TestItem(1)));
+        REQUIRE(queue.pop().value == 0);
+        REQUIRE(!queue.contains(TestItem(0)));
+    }
+}
 
 struct NoCopyItem {
     explicit NoCopyItem(int value) : value(value), index(std::numeric_limits<std::size_t>::max()) {}
@@ -384,5 +989,72 @@ TEST_CASE("Pop underflow expection test", "[DynamicPriorityQueue]") {
     REQUIRE_THROWS_AS(queue.top(), std::underflow_error);
 }
 
+template <std::size_t ARITY, bool BOTTOM_UP_POP>
+void testReplaceTop() {
+    constexpr int size = 1000;
+    DynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, size, size, ARITY, BOTTOM_UP_POP> queue;
+
+    auto items = makeItems(size);
+    auto replacements = makeItems(size);
+    for (auto& item : items) {
+        queue.push(&item);
+    }
+
+    // Every replacement is worse than all items left, so the items come out in order.
+    for (int i = 0; i < size; ++i) {
+        replacements[i].value += size;
+        TestItem* top = queue.replaceTop(&replacements[i]);
+        REQUIRE(top->value == i);
+        REQUIRE(top->index == std::numeric_limits<std::size_t>::max());
+        REQUIRE(queue.top()->index == 0);
+    }
+
+    for (int i = 0; i < size; ++i) {
+        REQUIRE(queue.pop()->value == size + i);
+    }
+}
+
+TEST_CASE("DynamicPriorityQueue replaceTop sift mode test", "[DynamicPriorityQueue]") {
+    testReplaceTop<2, false>();
+    testReplaceTop<2, true>();
+    testReplaceTop<4, true>();
+}
+
+TEST_CASE("DynamicPriorityQueue bottom-up pop test", "[DynamicPriorityQueue]") {
+    testArity<2, true>();
+    testArity<4, true>();
+
+    constexpr int size = 1000;
+    DynamicPriorityQueue<NoCopyItem, NoCopyRefIndexFunction, NoCopyRefCompare, size, size, 2, true> queue;
+
+    for (int i = 0; i < size; ++i) {
+        queue.push(NoCopyItem{scatteredValue(i, size)});
+    }
+
+    for (int i = 0; i < size; ++i) {
+        REQUIRE(queue.top().index == 0);
+        NoCopyItem item = queue.pop();
+        REQUIRE(item.value == i);
+        REQUIRE(item.index == std::numeric_limits<std::size_t>::max());
+    }
+}
+
+TEST_CASE("DynamicPriorityQueue popBatch move-only test", "[DynamicPriorityQueue]") {
+    DynamicPriorityQueue<NoCopyItem, NoCopyRefIndexFunction, NoCopyRefCompare> queue;
+    for (int i = 0; i < 100; ++i) {
+        queue.push(NoCopyItem{99 - i});
+    }
+
+    std::vector<NoCopyItem> batch;
+    queue.popBatch(150, std::back_inserter(batch));
+
+    REQUIRE(queue.empty());
+    REQUIRE(batch.size() == 100);
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(batch[i].value == i);
+        REQUIRE(batch[i].index == std::numeric_limits<std::size_t>::max());
+    }
+}
+
 } // namespace
 } // namespace cserna
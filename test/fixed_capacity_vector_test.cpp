@@ -0,0 +1,137 @@
+#include "catch.hpp"
+
+#include <memory>
+#include <random>
+
+#include "../include/dynamic_priority_queue.hpp"
+#include "../include/fixed_capacity_vector.hpp"
+
+namespace cserna {
+namespace {
+
+struct TestItem {
+    explicit TestItem(int value) : value(value) {}
+
+    int value;
+    std::size_t index = std::numeric_limits<std::size_t>::max();
+};
+
+struct IndexFunction {
+    std::size_t& operator()(TestItem* item) { return item->index; }
+    std::size_t operator()(const TestItem* item) const { return item->index; }
+};
+
+struct ItemCompare {
+    int operator()(const TestItem* lhs, const TestItem* rhs) const {
+        if (lhs->value < rhs->value)
+            return -1;
+        if (lhs->value > rhs->value)
+            return 1;
+        return 0;
+    }
+};
+
+TEST_CASE("FixedCapacityVector test", "[FixedCapacityVector]") {
+    FixedCapacityVector<std::unique_ptr<int>, 8> vector;
+    REQUIRE(vector.empty());
+    REQUIRE(vector.capacity() == 8);
+
+    for (int i = 0; i < 5; ++i) {
+        vector.push_back(std::unique_ptr<int>(new int(i)));
+    }
+    REQUIRE(vector.size() == 5);
+    REQUIRE(*vector.back() == 4);
+
+    vector.erase(vector.begin() + 1, vector.begin() + 3);
+    REQUIRE(vector.size() == 3);
+    REQUIRE(*vector[0] == 0);
+    REQUIRE(*vector[1] == 3);
+    REQUIRE(*vector[2] == 4);
+
+    FixedCapacityVector<std::unique_ptr<int>, 8> other;
+    other.push_back(std::unique_ptr<int>(new int(10)));
+
+    vector.swap(other);
+    REQUIRE(vector.size() == 1);
+    REQUIRE(*vector[0] == 10);
+    REQUIRE(other.size() == 3);
+    REQUIRE(*other[2] == 4);
+
+    FixedCapacityVector<std::unique_ptr<int>, 8> moved(std::move(other));
+    REQUIRE(other.empty());
+    REQUIRE(moved.size() == 3);
+
+    moved.pop_back();
+    moved.clear();
+    REQUIRE(moved.empty());
+}
+
+TEST_CASE("FixedCapacityDynamicPriorityQueue test", "[FixedCapacityVector]") {
+    constexpr int size = 64;
+    std::mt19937 random(5);
+
+    std::vector<TestItem> items;
+    items.reserve(size + 1);
+    for (int i = 0; i <= size; ++i) {
+        items.emplace_back(static_cast<int>(random() % 1000));
+    }
+
+    FixedCapacityDynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, size> queue;
+    for (int i = 0; i < size; ++i) {
+        queue.push(&items[i]);
+    }
+
+    REQUIRE(queue.size() == size);
+    REQUIRE_THROWS_AS(queue.push(&items[size]), std::overflow_error);
+
+    for (int i = 0; i < size; ++i) {
+        items[i].value = static_cast<int>(random() % 1000);
+        queue.update(&items[i]);
+    }
+
+    auto moved = std::move(queue);
+
+    int value = std::numeric_limits<int>::min();
+    while (!moved.empty()) {
+        REQUIRE(moved.top()->value >= value);
+        value = moved.pop()->value;
+    }
+
+    for (auto& item : items) {
+        REQUIRE(item.index == std::numeric_limits<std::size_t>::max());
+    }
+}
+
+TEST_CASE("FixedCapacityDynamicPriorityQueue bulk operations test", "[FixedCapacityVector]") {
+    constexpr int size = 32;
+    std::vector<TestItem> items;
+    std::vector<TestItem*> pointers;
+    items.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back((i * 7) % size);
+    }
+    for (auto& item : items) {
+        pointers.push_back(&item);
+    }
+
+    using Queue = FixedCapacityDynamicPriorityQueue<TestItem*, IndexFunction, ItemCompare, size, 4>;
+    Queue first(pointers.begin(), pointers.begin() + size / 4);
+    Queue second(pointers.begin() + size / 4, pointers.end());
+    REQUIRE_THROWS_AS(second.pushBulk(pointers.begin(), pointers.begin() + size / 2), std::overflow_error);
+
+    first.merge(std::move(second));
+    REQUIRE(first.size() == size);
+
+    std::vector<TestItem*> batch;
+    first.popBatch(size / 2, std::back_inserter(batch));
+    for (int i = 0; i < size / 2; ++i) {
+        REQUIRE(batch[i]->value == i);
+    }
+
+    for (int i = size / 2; i < size; ++i) {
+        REQUIRE(first.pop()->value == i);
+    }
+}
+
+} // namespace
+} // namespace cserna
@@ -0,0 +1,257 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+
+#include "../include/flat_combining_priority_queue.hpp"
+
+namespace cserna {
+namespace {
+
+struct TestItem {
+    explicit TestItem(int value) : value(value) {}
+
+    int value;
+    std::size_t index = std::numeric_limits<std::size_t>::max();
+};
+
+struct IndexFunction {
+    std::size_t& operator()(TestItem* item) { return item->index; }
+    std::size_t operator()(const TestItem* item) const { return item->index; }
+};
+
+struct ItemCompare {
+    int operator()(const TestItem* lhs, const TestItem* rhs) const {
+        if (lhs->value < rhs->value)
+            return -1;
+        if (lhs->value > rhs->value)
+            return 1;
+        return 0;
+    }
+};
+
+using Queue = FlatCombiningPriorityQueue<TestItem*, IndexFunction, ItemCompare>;
+
+constexpr int threadCount = 4;
+
+std::vector<TestItem> makeItems(const int size) {
+    std::vector<TestItem> items;
+    items.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back((i * 7919) % size);
+    }
+    return items;
+}
+
+TEST_CASE("FlatCombiningPriorityQueue sequential test", "[FlatCombiningPriorityQueue]") {
+    Queue queue(1);
+    auto handle = queue.handle();
+    REQUIRE_THROWS_AS(queue.handle(), std::overflow_error);
+
+    TestItem* item = nullptr;
+    REQUIRE(!handle.tryPop(item));
+
+    constexpr int size = 1000;
+    auto items = makeItems(size);
+
+    for (auto& item : items) {
+        handle.push(&item);
+    }
+    REQUIRE(queue.size() == size);
+
+    REQUIRE(handle.update(&items[1], [](TestItem* changed) { changed->value = -1; }));
+    REQUIRE(handle.remove(&items[0]));
+    REQUIRE(!handle.remove(&items[0]));
+    REQUIRE(!handle.update(&items[0], [](TestItem*) { FAIL("Not queued"); }));
+
+    REQUIRE(handle.tryPop(item));
+    REQUIRE(item == &items[1]);
+
+    int value = std::numeric_limits<int>::min();
+    while (handle.tryPop(item)) {
+        REQUIRE(item->value >= value);
+        REQUIRE(item->index == std::numeric_limits<std::size_t>::max());
+        value = item->value;
+    }
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("FlatCombiningPriorityQueue overflow test", "[FlatCombiningPriorityQueue]") {
+    FlatCombiningPriorityQueue<TestItem*, IndexFunction, ItemCompare, 2, 2> queue(1);
+    auto handle = queue.handle();
+
+    auto node0 = TestItem(0);
+    auto node1 = TestItem(1);
+    auto node2 = TestItem(2);
+
+    handle.push(&node0);
+    handle.push(&node1);
+    REQUIRE_THROWS_AS(handle.push(&node2), std::overflow_error);
+    REQUIRE(queue.size() == 2);
+}
+
+TEST_CASE("FlatCombiningPriorityQueue handle test", "[FlatCombiningPriorityQueue]") {
+    Queue queue(2);
+    auto items = makeItems(10);
+
+    {
+        auto first = queue.handle();
+        auto second = queue.handle();
+        REQUIRE_THROWS_AS(queue.handle(), std::overflow_error);
+        first.push(&items[0]);
+        second.push(&items[1]);
+    }
+
+    // The slots of destroyed handles are free again, and a moved handle keeps its slot.
+    auto handle = queue.handle();
+    auto other = queue.handle();
+    auto moved = std::move(other);
+    REQUIRE_THROWS_AS(queue.handle(), std::overflow_error);
+    handle = std::move(moved);
+    REQUIRE_NOTHROW(queue.handle());
+
+    TestItem* item = nullptr;
+    REQUIRE(handle.tryPop(item));
+    REQUIRE(handle.tryPop(item));
+    REQUIRE(!handle.tryPop(item));
+
+    // Threads that come and go get slots as long as no more than two run at the same time.
+    for (int round = 0; round < 10; ++round) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 2; ++t) {
+            threads.emplace_back([&queue, &items, round, t]() {
+                auto local = queue.handle();
+                local.push(&items[(round * 2 + t) % 10]);
+                TestItem* popped = nullptr;
+                local.tryPop(popped);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+}
+
+// Items held by value, whose positions are kept by id outside of them.
+struct Entry {
+    int id;
+    int value;
+};
+
+struct EntryId {
+    int operator()(const Entry& entry) const { return entry.id; }
+};
+
+struct EntryCompare {
+    int operator()(const Entry& lhs, const Entry& rhs) const {
+        if (lhs.value < rhs.value)
+            return -1;
+        if (lhs.value > rhs.value)
+            return 1;
+        return 0;
+    }
+};
+
+TEST_CASE("FlatCombiningPriorityQueue value item update test", "[FlatCombiningPriorityQueue]") {
+    FlatCombiningPriorityQueue<Entry, DenseIdIndexFunction<Entry, EntryId>, EntryCompare> queue(1);
+    auto handle = queue.handle();
+    for (int i = 0; i < 10; ++i) {
+        handle.push(Entry{i, i});
+    }
+
+    // The change has to reach the copy held by the queue, not the one passed in.
+    REQUIRE(handle.update(Entry{9, 9}, [](Entry& entry) { entry.value = -1; }));
+
+    Entry entry{0, 0};
+    REQUIRE(handle.tryPop(entry));
+    REQUIRE(entry.id == 9);
+    REQUIRE(entry.value == -1);
+    for (int i = 0; i < 9; ++i) {
+        REQUIRE(handle.tryPop(entry));
+        REQUIRE(entry.id == i);
+    }
+}
+
+TEST_CASE("FlatCombiningPriorityQueue parallel test", "[FlatCombiningPriorityQueue]") {
+    constexpr int perThread = 5000;
+    auto items = makeItems(threadCount * perThread);
+
+    Queue queue(threadCount + 1);
+
+    std::vector<std::vector<TestItem*>> popped(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&queue, &items, &popped, t]() {
+            auto handle = queue.handle();
+            std::mt19937 random(static_cast<unsigned>(t));
+
+            for (int i = 0; i < perThread; ++i) {
+                handle.push(&items[t * perThread + i]);
+
+                TestItem* item;
+                if (i % 2 == 0 && handle.tryPop(item)) {
+                    popped[t].push_back(item);
+                }
+
+                // Another thread may have popped the item already.
+                TestItem* own = &items[t * perThread + random() % (i + 1)];
+                const int value = static_cast<int>(random() % 100000);
+                handle.update(own, [value](TestItem* changed) { changed->value = value; });
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<TestItem*> all;
+    for (auto& items : popped) {
+        all.insert(all.end(), items.begin(), items.end());
+    }
+
+    auto handle = queue.handle();
+    TestItem* item;
+    int value = std::numeric_limits<int>::min();
+    while (handle.tryPop(item)) {
+        REQUIRE(item->value >= value);
+        value = item->value;
+        all.push_back(item);
+    }
+
+    REQUIRE(all.size() == items.size());
+    std::sort(all.begin(), all.end());
+    REQUIRE(std::unique(all.begin(), all.end()) == all.end());
+}
+
+TEST_CASE("FlatCombiningPriorityQueue NonIntrusiveIndexFunction test", "[FlatCombiningPriorityQueue]") {
+    FlatCombiningPriorityQueue<int, NonIntrusiveIndexFunction<int>, ThreeWayComparatorAdapter<int>> queue(
+            threadCount);
+
+    constexpr int perThread = 1000;
+    std::atomic<int> removed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&queue, &removed, t]() {
+            auto handle = queue.handle();
+            for (int i = 0; i < perThread; ++i) {
+                handle.push(t * perThread + i);
+            }
+            for (int i = 0; i < perThread; i += 2) {
+                if (handle.remove(t * perThread + i)) {
+                    ++removed;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(removed == threadCount * perThread / 2);
+    REQUIRE(queue.size() == threadCount * perThread / 2);
+}
+
+} // namespace
+} // namespace cserna
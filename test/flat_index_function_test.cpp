@@ -0,0 +1,114 @@
+#include "catch.hpp"
+
+#include "../include/dynamic_priority_queue.hpp"
+#include "../include/flat_index_function.hpp"
+
+namespace cserna {
+namespace {
+
+struct TestItem {
+    explicit TestItem(int value) : value(value) {}
+
+    int value;
+};
+
+struct ItemHash {
+    std::size_t operator()(const TestItem& item) const { return static_cast<std::size_t>(item.value); }
+};
+
+struct ItemEqual {
+    bool operator()(const TestItem& lhs, const TestItem& rhs) const { return lhs.value == rhs.value; }
+};
+
+struct ItemCompare {
+    int operator()(const TestItem& lhs, const TestItem& rhs) const {
+        if (lhs.value < rhs.value)
+            return -1;
+        if (lhs.value > rhs.value)
+            return 1;
+        return 0;
+    }
+};
+
+// Sends every key to the same home slot to exercise long probe sequences and backward shifting.
+struct CollidingHash {
+    std::size_t operator()(int) const { return 0; }
+};
+
+TEST_CASE("FlatIndexFunction lookup/erase test", "[FlatIndexFunction]") {
+    FlatIndexFunction<int> indexFunction;
+    const auto notInQueue = std::numeric_limits<std::size_t>::max();
+
+    const FlatIndexFunction<int>& constIndexFunction = indexFunction;
+    REQUIRE(constIndexFunction(1) == notInQueue);
+    REQUIRE(indexFunction.size() == 0);
+
+    constexpr int size = 1000;
+    for (int i = 0; i < size; ++i) {
+        int key = i * 16;
+        REQUIRE(indexFunction(key) == notInQueue);
+        indexFunction(key) = static_cast<std::size_t>(i);
+    }
+    REQUIRE(indexFunction.size() == size);
+
+    for (int i = 0; i < size; i += 2) {
+        indexFunction.erase(i * 16);
+    }
+    REQUIRE(indexFunction.size() == size / 2);
+
+    for (int i = 0; i < size; ++i) {
+        REQUIRE(constIndexFunction(i * 16) == (i % 2 == 0 ? notInQueue : static_cast<std::size_t>(i)));
+    }
+
+    FlatIndexFunction<int> copy(indexFunction);
+    REQUIRE(copy.size() == size / 2);
+    REQUIRE(static_cast<const FlatIndexFunction<int>&>(copy)(16) == 1);
+}
+
+TEST_CASE("FlatIndexFunction collision test", "[FlatIndexFunction]") {
+    FlatIndexFunction<int, CollidingHash> indexFunction;
+    const FlatIndexFunction<int, CollidingHash>& constIndexFunction = indexFunction;
+
+    for (int i = 0; i < 100; ++i) {
+        indexFunction(i) = static_cast<std::size_t>(i);
+    }
+
+    indexFunction.erase(0);
+    indexFunction.erase(50);
+    indexFunction.erase(99);
+
+    for (int i = 0; i < 100; ++i) {
+        const bool erased = i == 0 || i == 50 || i == 99;
+        const auto expected = erased ? std::numeric_limits<std::size_t>::max() : static_cast<std::size_t>(i);
+        REQUIRE(constIndexFunction(i) == expected);
+    }
+}
+
+TEST_CASE("FlatIndexFunction queue test", "[FlatIndexFunction]") {
+    DynamicPriorityQueue<TestItem, FlatIndexFunction<TestItem, ItemHash, ItemEqual>, ItemCompare, 100, 1000> queue;
+
+    constexpr int size = 1000;
+    for (int i = 0; i < size; ++i) {
+        queue.push(TestItem((i * 7919) % size));
+    }
+
+    for (int i = 0; i < size; ++i) {
+        REQUIRE(queue.contains(TestItem(i)));
+    }
+
+    queue.remove(TestItem(3));
+    REQUIRE(!queue.contains(TestItem(3)));
+
+    for (int i = 0; i < size; ++i) {
+        if (i == 3) {
+            continue;
+        }
+        REQUIRE(queue.pop().value == i);
+        REQUIRE(!queue.contains(TestItem(i)));
+    }
+
+    REQUIRE(queue.empty());
+}
+
+} // namespace
+} // namespace cserna
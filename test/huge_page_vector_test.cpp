@@ -0,0 +1,115 @@
+#include "catch.hpp"
+
+#include <cstdint>
+#include <random>
+
+#include "../include/dynamic_priority_queue.hpp"
+#include "../include/huge_page_vector.hpp"
+
+namespace cserna {
+namespace {
+
+struct TestItem {
+    explicit TestItem(int value) : value(value) {}
+
+    int value;
+    std::size_t index = std::numeric_limits<std::size_t>::max();
+};
+
+struct IndexFunction {
+    std::size_t& operator()(TestItem* item) { return item->index; }
+    std::size_t operator()(const TestItem* item) const { return item->index; }
+};
+
+struct ItemCompare {
+    int operator()(const TestItem* lhs, const TestItem* rhs) const {
+        if (lhs->value < rhs->value)
+            return -1;
+        if (lhs->value > rhs->value)
+            return 1;
+        return 0;
+    }
+};
+
+TEST_CASE("HugePageVector test", "[HugePageVector]") {
+    HugePageVector<std::uint64_t> vector;
+    REQUIRE(vector.empty());
+    REQUIRE(vector.begin() == vector.end());
+
+    // Enough items to remap the array a few times; it stays huge page aligned.
+    constexpr std::size_t size = 1000000;
+    for (std::size_t i = 0; i < size; ++i) {
+        vector.push_back(i);
+        if (i == 0 || vector.size() == vector.capacity()) {
+            const auto address = reinterpret_cast<std::uintptr_t>(vector.data());
+            REQUIRE(address % HugePageVector<std::uint64_t>::HUGE_PAGE_SIZE < 64);
+        }
+    }
+
+    REQUIRE(vector.size() == size);
+    REQUIRE(vector.capacity() >= size);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(vector.data()) % HugePageVector<std::uint64_t>::HUGE_PAGE_SIZE < 64);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(&vector[1]) % HugePageVector<std::uint64_t>::CACHE_LINE_SIZE == 0);
+    for (std::size_t i = 0; i < size; ++i) {
+        REQUIRE(vector[i] == i);
+    }
+
+    vector.erase(vector.begin() + 10, vector.end() - 10);
+    REQUIRE(vector.size() == 20);
+    REQUIRE(vector[10] == size - 10);
+
+    HugePageVector<std::uint64_t> other(HugePageMode::EXPLICIT);
+    other.push_back(42);
+    vector.swap(other);
+    REQUIRE(vector.size() == 1);
+    REQUIRE(vector.back() == 42);
+
+    HugePageVector<std::uint64_t> moved(std::move(other));
+    REQUIRE(other.empty());
+    REQUIRE(moved.size() == 20);
+
+    moved.pop_back();
+    moved.clear();
+    REQUIRE(moved.empty());
+}
+
+TEST_CASE("DynamicPriorityQueue with HugePageVector test", "[HugePageVector]") {
+    constexpr int size = 100000;
+    std::mt19937 random(9);
+
+    std::vector<TestItem> items;
+    items.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back(static_cast<int>(random() % 1000000));
+    }
+
+    using Storage = HugePageVector<TestItem*>;
+    DynamicPriorityQueue<TestItem*,
+            IndexFunction,
+            ItemCompare,
+            0,
+            std::numeric_limits<std::size_t>::max(),
+            8,
+            false,
+            std::size_t,
+            Storage>
+            queue;
+
+    for (auto& item : items) {
+        queue.push(&item);
+    }
+
+    for (int i = 0; i < size; i += 3) {
+        items[i].value = static_cast<int>(random() % 1000000);
+        queue.update(&items[i]);
+    }
+
+    int value = std::numeric_limits<int>::min();
+    while (!queue.empty()) {
+        REQUIRE(queue.top()->value >= value);
+        value = queue.pop()->value;
+    }
+}
+
+} // namespace
+} // namespace cserna
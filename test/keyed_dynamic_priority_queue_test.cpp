@@ -0,0 +1,129 @@
+#include "catch.hpp"
+
+#include "../include/keyed_dynamic_priority_queue.hpp"
+
+namespace cserna {
+namespace {
+
+struct TestItem {
+    explicit TestItem(int value) : value(value), index(std::numeric_limits<std::size_t>::max()) {}
+
+    int value;
+    std::size_t index;
+};
+
+struct IndexFunction {
+    std::size_t& operator()(TestItem* item) { return item->index; }
+    std::size_t operator()(const TestItem* item) const { return item->index; }
+};
+
+struct ValueProjection {
+    int operator()(const TestItem* item) const { return item->value; }
+};
+
+std::vector<TestItem> makeItems(const int size) {
+    std::vector<TestItem> items;
+    items.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back((i * 7919) % size);
+    }
+    return items;
+}
+
+TEST_CASE("KeyedDynamicPriorityQueue order test", "[KeyedDynamicPriorityQueue]") {
+    KeyedDynamicPriorityQueue<TestItem*, IndexFunction, ValueProjection> queue;
+
+    auto node0 = TestItem(0);
+    auto node1 = TestItem(1);
+    auto node2 = TestItem(2);
+
+    queue.push(&node1);
+    queue.push(&node2);
+    queue.push(&node0);
+
+    REQUIRE(queue.size() == 3);
+    REQUIRE(queue.top() == &node0);
+    REQUIRE(queue.topKey() == 0);
+    REQUIRE(node0.index == 0);
+
+    REQUIRE(queue.pop() == &node0);
+    REQUIRE(node0.index == std::numeric_limits<std::size_t>::max());
+    REQUIRE(queue.pop() == &node1);
+    REQUIRE(queue.pop() == &node2);
+    REQUIRE(queue.empty());
+    REQUIRE_THROWS_AS(queue.pop(), std::underflow_error);
+}
+
+TEST_CASE("KeyedDynamicPriorityQueue update refreshes key test", "[KeyedDynamicPriorityQueue]") {
+    KeyedDynamicPriorityQueue<TestItem*, IndexFunction, ValueProjection, ThreeWayComparatorAdapter<int>, 0,
+            std::numeric_limits<std::size_t>::max(), 4>
+            queue;
+
+    constexpr int size = 500;
+    auto items = makeItems(size);
+
+    for (auto& item : items) {
+        queue.push(&item);
+    }
+
+    // Changing the item alone does not affect the cached key until update is called.
+    items[0].value = -1;
+    REQUIRE(queue.topKey() == 0);
+    queue.update(&items[0]);
+    REQUIRE(queue.top() == &items[0]);
+    REQUIRE(queue.topKey() == -1);
+
+    for (int i = 1; i < size; i += 2) {
+        items[i].value += size;
+        queue.insertOrUpdate(&items[i]);
+    }
+
+    for (int i = 2; i < size; i += 7) {
+        queue.remove(&items[i]);
+        REQUIRE(!queue.contains(&items[i]));
+    }
+
+    int value = std::numeric_limits<int>::min();
+    while (!queue.empty()) {
+        REQUIRE(queue.top()->index == 0);
+        REQUIRE(queue.topKey() == queue.top()->value);
+        REQUIRE(queue.topKey() >= value);
+        value = queue.pop()->value;
+    }
+}
+
+// Items held by value, whose positions are kept by id outside of them.
+struct Entry {
+    int id;
+    int value;
+};
+
+struct EntryId {
+    int operator()(const Entry& entry) const { return entry.id; }
+};
+
+struct EntryValue {
+    int operator()(const Entry& entry) const { return entry.value; }
+};
+
+TEST_CASE("KeyedDynamicPriorityQueue value item update test", "[KeyedDynamicPriorityQueue]") {
+    KeyedDynamicPriorityQueue<Entry, DenseIdIndexFunction<Entry, EntryId>, EntryValue> queue;
+    for (int i = 0; i < 10; ++i) {
+        queue.push(Entry{i, i});
+    }
+
+    // The change has to reach the copy held by the queue, not the one passed in.
+    queue.update(Entry{9, 9}, [](Entry& entry) { entry.value = -1; });
+    REQUIRE(queue.topKey() == -1);
+    REQUIRE(queue.pop().id == 9);
+
+    queue.update(Entry{0, 0}, [](Entry& entry) { entry.value = 100; });
+    for (int i = 1; i < 9; ++i) {
+        REQUIRE(queue.pop().id == i);
+    }
+    REQUIRE(queue.pop().value == 100);
+    REQUIRE(queue.empty());
+}
+
+} // namespace
+} // namespace cserna
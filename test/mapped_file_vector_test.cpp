@@ -0,0 +1,308 @@
+#include "catch.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <system_error>
+
+#include <unistd.h>
+
+#include "../include/dynamic_priority_queue.hpp"
+#include "../include/mapped_file_vector.hpp"
+
+namespace cserna {
+namespace {
+
+// Items stored by value that carry their own position, so a reopened queue does not have to be reindexed.
+struct Node {
+    std::uint32_t id;
+    int value;
+    std::size_t index;
+};
+
+struct NodeIndexFunction {
+    std::size_t& operator()(Node& node) { return node.index; }
+    std::size_t operator()(const Node& node) const { return node.index; }
+};
+
+struct NodeCompare {
+    int operator()(const Node& lhs, const Node& rhs) const {
+        if (lhs.value < rhs.value)
+            return -1;
+        if (lhs.value > rhs.value)
+            return 1;
+        return 0;
+    }
+};
+
+struct IdProjection {
+    std::uint32_t operator()(std::uint32_t id) const { return id; }
+};
+
+// Compares ids by a value table, the way a planner keeps its node data next to the open list.
+struct IdCompare {
+    explicit IdCompare(const std::vector<int>* values = nullptr) : values(values) {}
+
+    int operator()(std::uint32_t lhs, std::uint32_t rhs) const {
+        if ((*values)[lhs] < (*values)[rhs])
+            return -1;
+        if ((*values)[lhs] > (*values)[rhs])
+            return 1;
+        return 0;
+    }
+
+    const std::vector<int>* values;
+};
+
+std::string temporaryPath() {
+    char path[] = "/tmp/mapped_file_vector_testXXXXXX";
+    const int fileDescriptor = mkstemp(path);
+    REQUIRE(fileDescriptor >= 0);
+    close(fileDescriptor);
+    return path;
+}
+
+TEST_CASE("MappedFileVector reopen test", "[MappedFileVector]") {
+    const std::string path = temporaryPath();
+
+    {
+        MappedFileVector<std::uint64_t> vector(path, 4);
+        for (std::uint64_t i = 0; i < 1000; ++i) {
+            vector.push_back(i);
+        }
+        vector.pop_back();
+        vector.sync();
+    }
+
+    {
+        MappedFileVector<std::uint64_t> vector(path);
+        REQUIRE(vector.size() == 999);
+        REQUIRE(vector.capacity() >= 999);
+        for (std::uint64_t i = 0; i < 999; ++i) {
+            REQUIRE(vector[i] == i);
+        }
+
+        MappedFileVector<std::uint64_t> moved(std::move(vector));
+        REQUIRE(vector.empty());
+        REQUIRE(moved.back() == 998);
+    }
+
+    REQUIRE_THROWS_AS(MappedFileVector<std::uint32_t>(path), std::runtime_error);
+
+    unlink(path.c_str());
+}
+
+// Copies the file as it is on disk right now, as a process that is killed at this point would leave it.
+std::string snapshot(const std::string& path) {
+    const std::string copy = temporaryPath();
+    std::ifstream source(path, std::ios::binary);
+    std::ofstream target(copy, std::ios::binary | std::ios::trunc);
+    target << source.rdbuf();
+    return copy;
+}
+
+TEST_CASE("MappedFileVector clean flag test", "[MappedFileVector]") {
+    const std::string path = temporaryPath();
+    MappedFileVector<std::uint64_t> vector(path);
+    for (std::uint64_t i = 0; i < 100; ++i) {
+        vector.push_back(i);
+    }
+
+    const std::string dirty = snapshot(path);
+    REQUIRE_THROWS_AS(MappedFileVector<std::uint64_t>(dirty), std::runtime_error);
+
+    vector.sync();
+    const std::string clean = snapshot(path);
+    {
+        MappedFileVector<std::uint64_t> reopened(clean);
+        REQUIRE(reopened.size() == 100);
+        REQUIRE(reopened.back() == 99);
+    }
+    // Closed cleanly again by the destructor.
+    REQUIRE(MappedFileVector<std::uint64_t>(clean).size() == 100);
+
+    // Any change after the sync makes the file unclean until the next one.
+    vector[0] = 1;
+    const std::string changed = snapshot(path);
+    REQUIRE_THROWS_AS(MappedFileVector<std::uint64_t>(changed), std::runtime_error);
+
+    unlink(dirty.c_str());
+    unlink(clean.c_str());
+    unlink(changed.c_str());
+    unlink(path.c_str());
+}
+
+TEST_CASE("MappedFileVector unwinding test", "[MappedFileVector]") {
+    const std::string path = temporaryPath();
+
+    // An exception in the middle of a sift leaves the items half moved, so the destructor must not mark them clean.
+    try {
+        MappedFileVector<std::uint64_t> vector(path);
+        vector.push_back(1);
+        vector.push_back(2);
+        vector.sync();
+        vector[0] = 2;
+        throw std::logic_error("Comparator failed.");
+    } catch (const std::logic_error&) {
+    }
+
+    REQUIRE_THROWS_AS(MappedFileVector<std::uint64_t>(path), std::runtime_error);
+
+    unlink(path.c_str());
+}
+
+TEST_CASE("MappedFileVector lock test", "[MappedFileVector]") {
+    const std::string path = temporaryPath();
+
+    {
+        MappedFileVector<std::uint64_t> vector(path);
+        vector.push_back(1);
+        REQUIRE_THROWS_AS(MappedFileVector<std::uint64_t>(path), std::system_error);
+        REQUIRE(vector.size() == 1);
+    }
+
+    // The lock is released with the file.
+    REQUIRE(MappedFileVector<std::uint64_t>(path).size() == 1);
+
+    unlink(path.c_str());
+}
+
+TEST_CASE("DynamicPriorityQueue on MappedFileVector test", "[MappedFileVector]") {
+    using Storage = MappedFileVector<Node>;
+    using Queue = DynamicPriorityQueue<Node,
+            NodeIndexFunction,
+            NodeCompare,
+            0,
+            std::numeric_limits<std::size_t>::max(),
+            2,
+            false,
+            std::size_t,
+            Storage>;
+
+    const std::string path = temporaryPath();
+    constexpr int size = 5000;
+    std::mt19937 random(13);
+
+    {
+        Queue queue{NodeCompare(), NodeIndexFunction(), Storage(path)};
+        for (int i = 0; i < size; ++i) {
+            queue.push(Node{static_cast<std::uint32_t>(i), static_cast<int>(random() % 100000), 0});
+        }
+        for (int i = 0; i < size / 2; ++i) {
+            queue.pop();
+        }
+    }
+
+    // The reopened queue continues where the previous process stopped.
+    Queue queue{NodeCompare(), NodeIndexFunction(), Storage(path)};
+    REQUIRE(queue.size() == size - size / 2);
+
+    Node top = queue.top();
+    top.value = -1;
+    queue.decreaseKey(top);
+    REQUIRE(queue.pop().id == top.id);
+
+    int value = std::numeric_limits<int>::min();
+    while (!queue.empty()) {
+        REQUIRE(queue.top().value >= value);
+        value = queue.pop().value;
+    }
+
+    unlink(path.c_str());
+}
+
+TEST_CASE("DynamicPriorityQueue on MappedFileVector merge test", "[MappedFileVector]") {
+    using Storage = MappedFileVector<Node>;
+    using Queue = DynamicPriorityQueue<Node,
+            NodeIndexFunction,
+            NodeCompare,
+            0,
+            std::numeric_limits<std::size_t>::max(),
+            2,
+            false,
+            std::size_t,
+            Storage>;
+
+    const std::string path = temporaryPath();
+    const std::string otherPath = temporaryPath();
+    constexpr int size = 1000;
+
+    {
+        Queue queue{NodeCompare(), NodeIndexFunction(), Storage(path)};
+        Queue other{NodeCompare(), NodeIndexFunction(), Storage(otherPath)};
+        for (int i = 0; i < size; ++i) {
+            Node node{static_cast<std::uint32_t>(i), (i * 7919) % size, 0};
+            if (i % 10 == 0) {
+                queue.push(node);
+            } else {
+                other.push(node);
+            }
+        }
+
+        // The other queue is larger, but its file must not become this queue's.
+        queue.merge(std::move(other));
+        REQUIRE(queue.size() == size);
+        REQUIRE(other.empty());
+    }
+
+    Queue queue{NodeCompare(), NodeIndexFunction(), Storage(path)};
+    REQUIRE(Queue(NodeCompare(), NodeIndexFunction(), Storage(otherPath)).empty());
+    REQUIRE(queue.size() == size);
+    for (int i = 0; i < size; ++i) {
+        REQUIRE(queue.pop().value == i);
+    }
+
+    unlink(path.c_str());
+    unlink(otherPath.c_str());
+}
+
+TEST_CASE("DynamicPriorityQueue reindex test", "[MappedFileVector]") {
+    using Storage = MappedFileVector<std::uint32_t>;
+    using Queue = DynamicPriorityQueue<std::uint32_t,
+            DenseIdIndexFunction<std::uint32_t, IdProjection>,
+            IdCompare,
+            0,
+            std::numeric_limits<std::size_t>::max(),
+            4,
+            false,
+            std::size_t,
+            Storage>;
+
+    const std::string path = temporaryPath();
+    constexpr std::uint32_t size = 1000;
+    std::vector<int> values(size);
+    for (std::uint32_t i = 0; i < size; ++i) {
+        values[i] = static_cast<int>((i * 7919) % size);
+    }
+
+    {
+        Queue queue{IdCompare(&values), DenseIdIndexFunction<std::uint32_t, IdProjection>(), Storage(path)};
+        for (std::uint32_t i = 0; i < size; ++i) {
+            queue.push(i);
+        }
+    }
+
+    // The positions were only known to the index function of the previous queue.
+    Queue queue{IdCompare(&values), DenseIdIndexFunction<std::uint32_t, IdProjection>(), Storage(path)};
+    REQUIRE(!queue.contains(0));
+    queue.reindex();
+    REQUIRE(queue.contains(0));
+
+    const int decreased = values[size - 1];
+    values[size - 1] = -1;
+    queue.decreaseKey(size - 1);
+    REQUIRE(queue.pop() == size - 1);
+
+    for (int i = 0; i < static_cast<int>(size); ++i) {
+        if (i != decreased) {
+            REQUIRE(values[queue.pop()] == i);
+        }
+    }
+    REQUIRE(queue.empty());
+
+    unlink(path.c_str());
+}
+
+} // namespace
+} // namespace cserna
@@ -0,0 +1,167 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <random>
+
+#include "../include/min_max_priority_queue.hpp"
+
+namespace cserna {
+namespace {
+
+struct TestItem {
+    explicit TestItem(int value) : value(value) {}
+
+    int value;
+    std::size_t index = std::numeric_limits<std::size_t>::max();
+};
+
+struct IndexFunction {
+    std::size_t& operator()(TestItem* item) { return item->index; }
+    std::size_t operator()(const TestItem* item) const { return item->index; }
+};
+
+struct ItemCompare {
+    int operator()(const TestItem* lhs, const TestItem* rhs) const {
+        if (lhs->value < rhs->value)
+            return -1;
+        if (lhs->value > rhs->value)
+            return 1;
+        return 0;
+    }
+};
+
+std::vector<TestItem> makeItems(const int size) {
+    std::vector<TestItem> items;
+    items.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back((i * 7919) % size);
+    }
+    return items;
+}
+
+TEST_CASE("MinMaxPriorityQueue double ended test", "[MinMaxPriorityQueue]") {
+    MinMaxPriorityQueue<TestItem*, IndexFunction, ItemCompare> queue;
+
+    REQUIRE_THROWS_AS(queue.popMin(), std::underflow_error);
+    REQUIRE_THROWS_AS(queue.popMax(), std::underflow_error);
+    REQUIRE_THROWS_AS(queue.topMax(), std::underflow_error);
+
+    constexpr int size = 1000;
+    auto items = makeItems(size);
+
+    for (auto& item : items) {
+        queue.push(&item);
+    }
+
+    REQUIRE(queue.topMin()->value == 0);
+    REQUIRE(queue.topMax()->value == size - 1);
+
+    int low = 0;
+    int high = size - 1;
+    while (!queue.empty()) {
+        TestItem* min = queue.popMin();
+        REQUIRE(min->value == low++);
+        REQUIRE(!queue.contains(min));
+
+        if (!queue.empty()) {
+            TestItem* max = queue.popMax();
+            REQUIRE(max->value == high--);
+            REQUIRE(max->index == std::numeric_limits<std::size_t>::max());
+        }
+    }
+}
+
+TEST_CASE("MinMaxPriorityQueue update/remove test", "[MinMaxPriorityQueue]") {
+    MinMaxPriorityQueue<TestItem*, IndexFunction, ItemCompare> queue;
+
+    constexpr int size = 1000;
+    std::mt19937 random(11);
+
+    std::vector<TestItem> items;
+    items.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back(static_cast<int>(random() % 5000));
+    }
+
+    for (auto& item : items) {
+        queue.push(&item);
+    }
+
+    for (int i = 0; i < 2 * size; ++i) {
+        TestItem& item = items[random() % size];
+        if (random() % 4 == 0) {
+            queue.remove(&item);
+        } else {
+            item.value = static_cast<int>(random() % 5000);
+            queue.insertOrUpdate(&item);
+        }
+
+        if (i % 50 == 0) {
+            int min = std::numeric_limits<int>::max();
+            int max = std::numeric_limits<int>::min();
+            for (auto& other : items) {
+                if (queue.contains(&other)) {
+                    min = std::min(min, other.value);
+                    max = std::max(max, other.value);
+                }
+            }
+            REQUIRE(queue.topMin()->value == min);
+            REQUIRE(queue.topMax()->value == max);
+        }
+    }
+
+    int value = std::numeric_limits<int>::min();
+    while (!queue.empty()) {
+        REQUIRE(queue.top()->value >= value);
+        value = queue.pop()->value;
+    }
+}
+
+TEST_CASE("MinMaxPriorityQueue overflow policy test", "[MinMaxPriorityQueue]") {
+    std::vector<TestItem> items;
+    for (int i = 0; i < 10; ++i) {
+        items.emplace_back(i);
+    }
+
+    SECTION("Throw") {
+        MinMaxPriorityQueue<TestItem*, IndexFunction, ItemCompare, 3, 3> queue;
+        queue.push(&items[0]);
+        queue.push(&items[1]);
+        queue.push(&items[2]);
+        REQUIRE_THROWS_AS(queue.push(&items[3]), std::overflow_error);
+    }
+
+    SECTION("Evict worst") {
+        MinMaxPriorityQueue<TestItem*, IndexFunction, ItemCompare, 3, 3, OverflowPolicy::EVICT_WORST> queue;
+        std::vector<TestItem*> evicted;
+        auto evict = [&evicted](TestItem* item) { evicted.push_back(item); };
+
+        queue.push(&items[5], evict);
+        queue.push(&items[3], evict);
+        queue.push(&items[7], evict);
+        REQUIRE(evicted.empty());
+
+        // Worse than the worst: rejected
+        queue.push(&items[8], evict);
+        REQUIRE(evicted.size() == 1);
+        REQUIRE(evicted.back() == &items[8]);
+        REQUIRE(!queue.contains(&items[8]));
+
+        // Better than the worst: the worst is evicted
+        queue.push(&items[1], evict);
+        REQUIRE(evicted.size() == 2);
+        REQUIRE(evicted.back() == &items[7]);
+        REQUIRE(items[7].index == std::numeric_limits<std::size_t>::max());
+
+        queue.push(&items[0]);
+        REQUIRE(queue.size() == 3);
+        REQUIRE(!queue.contains(&items[5]));
+
+        REQUIRE(queue.popMax() == &items[3]);
+        REQUIRE(queue.popMin() == &items[0]);
+        REQUIRE(queue.popMin() == &items[1]);
+    }
+}
+
+} // namespace
+} // namespace cserna
@@ -0,0 +1,209 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+#include "../include/multi_queue.hpp"
+
+namespace cserna {
+namespace {
+
+struct TestItem {
+    explicit TestItem(int value) : value(value) {}
+
+    int value;
+    std::size_t index = std::numeric_limits<std::size_t>::max();
+    std::atomic<std::size_t> queueId{std::numeric_limits<std::size_t>::max()};
+};
+
+struct IndexFunction {
+    using is_intrusive = std::true_type;
+
+    std::size_t& operator()(TestItem* item) { return item->index; }
+    std::size_t operator()(const TestItem* item) const { return item->index; }
+};
+
+struct QueueIdFunction {
+    std::atomic<std::size_t>& operator()(TestItem* item) const { return item->queueId; }
+};
+
+struct ItemCompare {
+    int operator()(const TestItem* lhs, const TestItem* rhs) const {
+        if (lhs->value < rhs->value)
+            return -1;
+        if (lhs->value > rhs->value)
+            return 1;
+        return 0;
+    }
+};
+
+using Queue = MultiQueue<TestItem*, IndexFunction, ItemCompare, QueueIdFunction>;
+
+constexpr int threadCount = 4;
+
+std::vector<std::unique_ptr<TestItem>> makeItems(const int size) {
+    std::vector<std::unique_ptr<TestItem>> items;
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back(new TestItem((i * 7919) % size));
+    }
+    return items;
+}
+
+TEST_CASE("MultiQueue sequential test", "[MultiQueue]") {
+    constexpr int size = 1000;
+    auto items = makeItems(size);
+
+    Queue queue(threadCount, 2, 4);
+    REQUIRE(queue.queueCount() == 8);
+
+    auto handle = queue.handle(1);
+    TestItem* item = nullptr;
+    REQUIRE(!handle.tryPop(item));
+
+    for (auto& item : items) {
+        handle.push(item.get());
+    }
+    REQUIRE(queue.size() == size);
+
+    // Move the worst item to the front, drop the best one.
+    TestItem* worst = items[std::find_if(items.begin(), items.end(), [](const std::unique_ptr<TestItem>& item) {
+        return item->value == size - 1;
+    }) - items.begin()].get();
+    REQUIRE(queue.update(worst, [](TestItem* item) { item->value = -1; }));
+
+    TestItem* best = items[0].get();
+    REQUIRE(best->value == 0);
+    REQUIRE(queue.remove(best));
+    REQUIRE(!queue.contains(best));
+    REQUIRE(!queue.remove(best));
+    REQUIRE(!queue.update(best, [](TestItem*) { FAIL("Not queued"); }));
+
+    // Pops are relaxed: each one returns one of the two tops it looked at, so the rank error stays small.
+    std::vector<int> values;
+    while (handle.tryPop(item)) {
+        REQUIRE(!queue.contains(item));
+        values.push_back(item->value);
+    }
+
+    REQUIRE(queue.empty());
+    REQUIRE(values.size() == size - 1);
+    REQUIRE(std::find(values.begin(), values.end(), -1) - values.begin() < size / 10);
+
+    std::sort(values.begin(), values.end());
+    REQUIRE(values.front() == -1);
+    REQUIRE(std::adjacent_find(values.begin(), values.end()) == values.end());
+}
+
+// Items held by value, with their bookkeeping in a slot that does not move.
+struct Slot {
+    std::size_t index = std::numeric_limits<std::size_t>::max();
+    std::atomic<std::size_t> queueId{std::numeric_limits<std::size_t>::max()};
+};
+
+struct Entry {
+    int value;
+    Slot* slot;
+};
+
+struct EntryIndexFunction {
+    using is_intrusive = std::true_type;
+
+    std::size_t& operator()(Entry& entry) { return entry.slot->index; }
+    std::size_t operator()(const Entry& entry) const { return entry.slot->index; }
+};
+
+struct EntryQueueIdFunction {
+    std::atomic<std::size_t>& operator()(const Entry& entry) const { return entry.slot->queueId; }
+};
+
+struct EntryCompare {
+    int operator()(const Entry& lhs, const Entry& rhs) const {
+        if (lhs.value < rhs.value)
+            return -1;
+        if (lhs.value > rhs.value)
+            return 1;
+        return 0;
+    }
+};
+
+TEST_CASE("MultiQueue value item update test", "[MultiQueue]") {
+    constexpr int size = 100;
+    std::vector<Slot> slots(size);
+
+    MultiQueue<Entry, EntryIndexFunction, EntryCompare, EntryQueueIdFunction> queue(1, 1);
+    auto handle = queue.handle(1);
+    for (int i = 0; i < size; ++i) {
+        handle.push(Entry{i, &slots[i]});
+    }
+
+    // The change has to reach the copy held by the queue, not the one passed in.
+    REQUIRE(queue.update(Entry{size - 1, &slots[size - 1]}, [](Entry& entry) { entry.value = -1; }));
+
+    std::vector<int> values;
+    Entry entry{0, nullptr};
+    while (handle.tryPop(entry)) {
+        values.push_back(entry.value);
+    }
+
+    REQUIRE(values.size() == size);
+    REQUIRE(std::find(values.begin(), values.end(), -1) - values.begin() < 2);
+    REQUIRE(std::find(values.begin(), values.end(), size - 1) == values.end());
+}
+
+TEST_CASE("MultiQueue parallel test", "[MultiQueue]") {
+    constexpr int perThread = 5000;
+    auto items = makeItems(threadCount * perThread);
+
+    Queue queue(threadCount);
+
+    // Every thread pushes its own items and pops whatever it gets, while it also changes the keys of its own items
+    // that are still queued; an item may be popped by another thread at any time.
+    std::vector<std::vector<TestItem*>> popped(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&queue, &items, &popped, t]() {
+            auto handle = queue.handle(static_cast<unsigned>(t + 1));
+            std::mt19937 random(static_cast<unsigned>(t));
+
+            for (int i = 0; i < perThread; ++i) {
+                handle.push(items[t * perThread + i].get());
+
+                TestItem* item;
+                if (i % 2 == 0 && handle.tryPop(item)) {
+                    popped[t].push_back(item);
+                }
+
+                TestItem* own = items[t * perThread + random() % (i + 1)].get();
+                const int value = static_cast<int>(random() % 100000);
+                queue.update(own, [value](TestItem* changed) { changed->value = value; });
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<TestItem*> all;
+    for (auto& items : popped) {
+        all.insert(all.end(), items.begin(), items.end());
+    }
+
+    auto handle = queue.handle(42);
+    TestItem* item;
+    while (handle.tryPop(item)) {
+        all.push_back(item);
+    }
+
+    REQUIRE(queue.empty());
+    REQUIRE(all.size() == items.size());
+    std::sort(all.begin(), all.end());
+    REQUIRE(std::unique(all.begin(), all.end()) == all.end());
+    for (auto& item : items) {
+        REQUIRE(!queue.contains(item.get()));
+        REQUIRE(item->index == std::numeric_limits<std::size_t>::max());
+    }
+}
+
+} // namespace
+} // namespace cserna
@@ -0,0 +1,318 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+
+#include "../include/pairing_priority_queue.hpp"
+
+namespace cserna {
+namespace {
+
+struct TestItem {
+    explicit TestItem(int value) : value(value) {}
+
+    int value;
+    std::size_t index = std::numeric_limits<std::size_t>::max();
+};
+
+struct IndexFunction {
+    using is_intrusive = std::true_type;
+
+    std::size_t& operator()(TestItem* item) { return item->index; }
+    std::size_t operator()(const TestItem* item) const { return item->index; }
+};
+
+struct ItemCompare {
+    int operator()(const TestItem* lhs, const TestItem* rhs) const {
+        if (lhs->value < rhs->value)
+            return -1;
+        if (lhs->value > rhs->value)
+            return 1;
+        return 0;
+    }
+};
+
+using Queue = PairingPriorityQueue<TestItem*, IndexFunction, ItemCompare>;
+
+std::vector<TestItem> makeItems(const int size) {
+    std::vector<TestItem> items;
+    items.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back((i * 7919) % size);
+    }
+    return items;
+}
+
+TEST_CASE("PairingPriorityQueue order test", "[PairingPriorityQueue]") {
+    Queue queue;
+
+    REQUIRE(queue.empty());
+    REQUIRE_THROWS_AS(queue.pop(), std::underflow_error);
+    REQUIRE_THROWS_AS(queue.top(), std::underflow_error);
+
+    auto node0 = TestItem(0);
+    auto node1 = TestItem(1);
+    auto node2 = TestItem(2);
+
+    queue.push(&node1);
+    queue.push(&node2);
+    queue.push(&node0);
+
+    REQUIRE(queue.size() == 3);
+    REQUIRE(queue.top() == &node0);
+    REQUIRE(queue.contains(&node2));
+
+    REQUIRE(queue.pop() == &node0);
+    REQUIRE(!queue.contains(&node0));
+    REQUIRE(queue.pop() == &node1);
+    REQUIRE(queue.pop() == &node2);
+    REQUIRE(queue.empty());
+
+    queue.push(&node0);
+    queue.push(&node1);
+    queue.clear();
+    REQUIRE(queue.empty());
+    REQUIRE(!queue.contains(&node0));
+    REQUIRE(!queue.contains(&node1));
+}
+
+TEST_CASE("PairingPriorityQueue randomized test", "[PairingPriorityQueue]") {
+    constexpr int size = 2000;
+    std::mt19937 random(42);
+
+    std::vector<TestItem> items;
+    items.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back(static_cast<int>(random() % 10000));
+    }
+
+    Queue queue;
+    for (auto& item : items) {
+        queue.push(&item);
+    }
+
+    for (int i = 0; i < size; ++i) {
+        TestItem& item = items[random() % size];
+        switch (random() % 4) {
+        case 0:
+            item.value -= static_cast<int>(random() % 100);
+            queue.insertOrDecrease(&item);
+            break;
+        case 1:
+            item.value += static_cast<int>(random() % 100);
+            if (queue.contains(&item)) {
+                queue.increaseKey(&item);
+            }
+            break;
+        case 2:
+            item.value = static_cast<int>(random() % 10000);
+            queue.insertOrUpdate(&item);
+            break;
+        default:
+            queue.remove(&item);
+            REQUIRE(!queue.contains(&item));
+            break;
+        }
+
+        if (i % 10 == 0 && !queue.empty()) {
+            const int top = queue.top()->value;
+            for (auto& other : items) {
+                if (queue.contains(&other)) {
+                    REQUIRE(other.value >= top);
+                }
+            }
+            queue.pop();
+        }
+    }
+
+    std::size_t forEachCount = 0;
+    queue.forEach([&forEachCount](TestItem*) { ++forEachCount; });
+    REQUIRE(forEachCount == queue.size());
+
+    int value = std::numeric_limits<int>::min();
+    while (!queue.empty()) {
+        REQUIRE(queue.top()->value >= value);
+        value = queue.pop()->value;
+    }
+
+    for (auto& item : items) {
+        REQUIRE(!queue.contains(&item));
+    }
+}
+
+TEST_CASE("PairingPriorityQueue merge test", "[PairingPriorityQueue]") {
+    constexpr int size = 1000;
+    auto items = makeItems(size);
+
+    Queue small;
+    Queue large;
+    for (int i = 0; i < size; ++i) {
+        if (i % 10 == 0) {
+            small.push(&items[i]);
+        } else {
+            large.push(&items[i]);
+        }
+    }
+
+    // Leave some structure and free slots behind in both pools.
+    small.pop();
+    large.pop();
+
+    SECTION("Merge larger into smaller") {
+        small.merge(std::move(large));
+        REQUIRE(large.empty());
+        REQUIRE(small.size() == size - 2);
+
+        items[size - 1].value = -1;
+        small.decreaseKey(&items[size - 1]);
+        REQUIRE(small.pop() == &items[size - 1]);
+
+        int value = std::numeric_limits<int>::min();
+        while (!small.empty()) {
+            REQUIRE(small.top()->value >= value);
+            value = small.pop()->value;
+        }
+    }
+
+    SECTION("Merge smaller into larger") {
+        large.merge(std::move(small));
+        REQUIRE(small.empty());
+        REQUIRE(large.size() == size - 2);
+
+        int value = std::numeric_limits<int>::min();
+        while (!large.empty()) {
+            REQUIRE(large.top()->value >= value);
+            value = large.pop()->value;
+        }
+    }
+
+    for (auto& item : items) {
+        REQUIRE(!small.contains(&item));
+    }
+}
+
+struct ValueCompare {
+    int operator()(const TestItem& lhs, const TestItem& rhs) const { return ItemCompare()(&lhs, &rhs); }
+};
+
+// Has no default constructor, so the index function using it has to be passed in.
+struct OffsetIdProjection {
+    explicit OffsetIdProjection(const int offset) : offset(offset) {}
+
+    std::uint32_t operator()(const TestItem& item) const { return static_cast<std::uint32_t>(item.value - offset); }
+
+    int offset;
+};
+
+TEST_CASE("PairingPriorityQueue DenseIdIndexFunction merge test", "[PairingPriorityQueue]") {
+    using Index = DenseIdIndexFunction<TestItem, OffsetIdProjection>;
+    using ValueQueue = PairingPriorityQueue<TestItem, Index, ValueCompare>;
+
+    ValueQueue small(ValueCompare(), Index(OffsetIdProjection(100)));
+    ValueQueue large(ValueCompare(), Index(OffsetIdProjection(100)));
+    ValueQueue tiny(ValueCompare(), Index(OffsetIdProjection(100)));
+    for (int i = 100; i < 200; ++i) {
+        if (i % 4 == 0) {
+            small.push(TestItem(i));
+        } else if (i != 199) {
+            large.push(TestItem(i));
+        }
+    }
+    tiny.push(TestItem(199));
+
+    // The larger queue's nodes stay in place, the smaller one's are relocated.
+    small.merge(std::move(large));
+    small.merge(std::move(tiny));
+    REQUIRE(small.size() == 100);
+    REQUIRE(!large.contains(TestItem(101)));
+    REQUIRE(!tiny.contains(TestItem(199)));
+
+    // The emptied queues keep their index functions.
+    large.push(TestItem(150));
+    REQUIRE(large.contains(TestItem(150)));
+    REQUIRE(large.pop().value == 150);
+
+    small.remove(TestItem(150));
+    for (int i = 100; i < 200; ++i) {
+        if (i != 150) {
+            REQUIRE(small.contains(TestItem(i)));
+            REQUIRE(small.pop().value == i);
+        }
+    }
+}
+
+// Keeps the handles in a map and records every item it is told to forget.
+struct RecordingIndexFunction {
+    explicit RecordingIndexFunction(std::vector<const TestItem*>& erased) : erased(&erased) {}
+
+    std::size_t& operator()(TestItem* item) {
+        return indices.emplace(item, std::numeric_limits<std::size_t>::max()).first->second;
+    }
+
+    std::size_t operator()(const TestItem* item) const {
+        const auto it = indices.find(item);
+        return it == indices.end() ? std::numeric_limits<std::size_t>::max() : it->second;
+    }
+
+    void erase(TestItem* item) {
+        indices.erase(item);
+        erased->push_back(item);
+    }
+
+    std::unordered_map<const TestItem*, std::size_t> indices;
+    std::vector<const TestItem*>* erased;
+};
+
+TEST_CASE("PairingPriorityQueue non-intrusive merge test", "[PairingPriorityQueue]") {
+    using RecordingQueue = PairingPriorityQueue<TestItem*, RecordingIndexFunction, ItemCompare>;
+
+    constexpr int size = 7;
+    auto items = makeItems(size);
+
+    std::vector<const TestItem*> smallErased;
+    std::vector<const TestItem*> largeErased;
+    RecordingQueue small{ItemCompare(), RecordingIndexFunction(smallErased)};
+    RecordingQueue large{ItemCompare(), RecordingIndexFunction(largeErased)};
+    for (int i = 0; i < size; ++i) {
+        if (i < 2) {
+            small.push(&items[i]);
+        } else {
+            large.push(&items[i]);
+        }
+    }
+
+    // The nodes are swapped, so only the items that came from the larger queue leave its index function.
+    small.merge(std::move(large));
+    REQUIRE(smallErased.empty());
+    REQUIRE(largeErased.size() == size - 2);
+    for (int i = 2; i < size; ++i) {
+        REQUIRE(std::find(largeErased.begin(), largeErased.end(), &items[i]) != largeErased.end());
+    }
+
+    for (auto& item : items) {
+        REQUIRE(small.contains(&item));
+        REQUIRE(!large.contains(&item));
+    }
+
+    int value = std::numeric_limits<int>::min();
+    while (!small.empty()) {
+        REQUIRE(small.top()->value >= value);
+        value = small.pop()->value;
+    }
+}
+
+TEST_CASE("PairingPriorityQueue overflow test", "[PairingPriorityQueue]") {
+    PairingPriorityQueue<TestItem*, IndexFunction, ItemCompare, 2, 2> queue;
+
+    auto node0 = TestItem(0);
+    auto node1 = TestItem(1);
+    auto node2 = TestItem(2);
+
+    queue.push(&node0);
+    queue.push(&node1);
+    REQUIRE_THROWS_AS(queue.push(&node2), std::overflow_error);
+}
+
+} // namespace
+} // namespace cserna
@@ -0,0 +1,163 @@
+#include "catch.hpp"
+
+#include <cstdint>
+#include <random>
+
+#include "../include/radix_priority_queue.hpp"
+
+namespace cserna {
+namespace {
+
+struct TestItem {
+    explicit TestItem(std::uint32_t value) : value(value) {}
+
+    std::uint32_t value;
+    std::size_t index = std::numeric_limits<std::size_t>::max();
+};
+
+struct IndexFunction {
+    std::size_t& operator()(TestItem* item) { return item->index; }
+    std::size_t operator()(const TestItem* item) const { return item->index; }
+};
+
+struct ValueProjection {
+    std::uint32_t operator()(const TestItem* item) const { return item->value; }
+};
+
+using Queue = RadixPriorityQueue<TestItem*, IndexFunction, ValueProjection>;
+
+TEST_CASE("RadixPriorityQueue order test", "[RadixPriorityQueue]") {
+    Queue queue;
+
+    REQUIRE(queue.empty());
+    REQUIRE_THROWS_AS(queue.pop(), std::underflow_error);
+
+    auto node0 = TestItem(0);
+    auto node1 = TestItem(1);
+    auto node2 = TestItem(1000);
+    auto node3 = TestItem(7);
+
+    queue.push(&node1);
+    queue.push(&node2);
+    queue.push(&node0);
+    queue.push(&node3);
+
+    REQUIRE(queue.size() == 4);
+    REQUIRE(queue.top() == &node0);
+    REQUIRE(queue.topKey() == 0);
+
+    REQUIRE(queue.pop() == &node0);
+    REQUIRE(!queue.contains(&node0));
+
+    node2.value = 5;
+    queue.decreaseKey(&node2);
+
+    queue.remove(&node3);
+    REQUIRE(!queue.contains(&node3));
+
+    REQUIRE(queue.pop() == &node1);
+    REQUIRE(queue.pop() == &node2);
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("RadixPriorityQueue peek then push test", "[RadixPriorityQueue]") {
+    Queue queue;
+    auto node4 = TestItem(4);
+    auto node9 = TestItem(9);
+    auto node12 = TestItem(12);
+
+    queue.push(&node4);
+    REQUIRE(queue.pop() == &node4);
+    queue.push(&node12);
+
+    // A peek must not raise the lowest key that may still be pushed.
+    REQUIRE(queue.topKey() == 12);
+    REQUIRE(queue.top() == &node12);
+    queue.push(&node9);
+
+    REQUIRE(queue.topKey() == 9);
+    REQUIRE(queue.pop() == &node9);
+    REQUIRE(queue.pop() == &node12);
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("RadixPriorityQueue monotone search test", "[RadixPriorityQueue]") {
+    constexpr int size = 5000;
+    std::mt19937 random(7);
+
+    std::vector<TestItem> items;
+    items.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back(std::numeric_limits<std::uint32_t>::max());
+    }
+
+    Queue queue;
+    items[0].value = 0;
+    queue.push(&items[0]);
+
+    // Dijkstra-like relaxation: new keys are never smaller than the last popped key.
+    std::uint32_t lastKey = 0;
+    std::vector<bool> closed(size, false);
+    while (!queue.empty()) {
+        TestItem* item = queue.pop();
+        REQUIRE(item->value >= lastKey);
+        REQUIRE(item->index == std::numeric_limits<std::size_t>::max());
+        lastKey = item->value;
+        closed[static_cast<std::size_t>(item - items.data())] = true;
+
+        for (int k = 0; k < 4; ++k) {
+            TestItem& successor = items[random() % size];
+            if (closed[static_cast<std::size_t>(&successor - items.data())]) {
+                continue;
+            }
+
+            const std::uint32_t value = item->value + random() % 100;
+            if (value < successor.value) {
+                successor.value = value;
+                queue.insertOrDecrease(&successor);
+            }
+        }
+    }
+}
+
+// Items held by value, whose positions are kept by id outside of them.
+struct Entry {
+    std::uint32_t id;
+    std::uint32_t value;
+};
+
+struct EntryId {
+    std::uint32_t operator()(const Entry& entry) const { return entry.id; }
+};
+
+struct EntryValue {
+    std::uint32_t operator()(const Entry& entry) const { return entry.value; }
+};
+
+TEST_CASE("RadixPriorityQueue value item decrease test", "[RadixPriorityQueue]") {
+    RadixPriorityQueue<Entry, DenseIdIndexFunction<Entry, EntryId>, EntryValue> queue;
+    for (std::uint32_t i = 0; i < 10; ++i) {
+        queue.push(Entry{i, 10 + i});
+    }
+
+    // The change has to reach the copy held by the queue, not the one passed in.
+    queue.decreaseKey(Entry{9, 19}, [](Entry& entry) { entry.value = 1; });
+    REQUIRE(queue.topKey() == 1);
+    Entry top = queue.pop();
+    REQUIRE(top.id == 9);
+    REQUIRE(top.value == 1);
+
+    // Without a change the caller's copy replaces the queued one.
+    queue.decreaseKey(Entry{8, 2});
+    top = queue.pop();
+    REQUIRE(top.id == 8);
+    REQUIRE(top.value == 2);
+
+    for (std::uint32_t i = 0; i < 8; ++i) {
+        REQUIRE(queue.pop().id == i);
+    }
+    REQUIRE(queue.empty());
+}
+
+} // namespace
+} // namespace cserna
@@ -0,0 +1,254 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+#include "../include/skip_list_priority_queue.hpp"
+
+namespace cserna {
+namespace {
+
+struct TestItem {
+    std::atomic<std::size_t> ticket{std::numeric_limits<std::size_t>::max()};
+};
+
+// The queue keeps copies of the entries, so a key change pushes a new entry for the same item.
+struct Entry {
+    int value = 0;
+    TestItem* item = nullptr;
+};
+
+struct IndexFunction {
+    std::atomic<std::size_t>& operator()(const Entry& entry) const { return entry.item->ticket; }
+};
+
+struct EntryCompare {
+    int operator()(const Entry& lhs, const Entry& rhs) const {
+        if (lhs.value < rhs.value)
+            return -1;
+        if (lhs.value > rhs.value)
+            return 1;
+        return 0;
+    }
+};
+
+using Queue = SkipListPriorityQueue<Entry, IndexFunction, EntryCompare>;
+
+constexpr int threadCount = 4;
+
+std::vector<std::unique_ptr<TestItem>> makeItems(const int size) {
+    std::vector<std::unique_ptr<TestItem>> items;
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back(new TestItem());
+    }
+    return items;
+}
+
+Entry entry(const std::unique_ptr<TestItem>& item, const int value) {
+    Entry entry;
+    entry.value = value;
+    entry.item = item.get();
+    return entry;
+}
+
+TEST_CASE("SkipListPriorityQueue sequential test", "[SkipListPriorityQueue]") {
+    constexpr int size = 1000;
+    auto items = makeItems(size);
+
+    // A small bound offset unlinks the deleted prefix often.
+    Queue queue(1, 4);
+    Entry popped;
+    REQUIRE(!queue.tryPop(popped));
+
+    for (int i = 0; i < size; ++i) {
+        queue.push(entry(items[i], (i * 7919) % size + 1));
+    }
+    REQUIRE(queue.size() == size);
+
+    // Move the last item to the front, drop the first one.
+    REQUIRE(queue.decreaseKey(entry(items[size - 1], 0)));
+    REQUIRE(queue.remove(entry(items[0], 0)));
+    REQUIRE(!queue.contains(entry(items[0], 0)));
+    REQUIRE(!queue.remove(entry(items[0], 0)));
+    REQUIRE(!queue.update(entry(items[0], 0)));
+    REQUIRE(queue.size() == size - 2 + 1);
+
+    std::vector<int> values;
+    while (queue.tryPop(popped)) {
+        REQUIRE(!queue.contains(popped));
+        values.push_back(popped.value);
+    }
+
+    REQUIRE(queue.empty());
+    REQUIRE(values.size() == size - 1);
+    REQUIRE(values.front() == 0);
+    REQUIRE(std::is_sorted(values.begin(), values.end()));
+    REQUIRE(std::adjacent_find(values.begin(), values.end()) == values.end());
+
+    // The queue is empty again and can be reused; collect() frees what the last pops retired.
+    queue.collect();
+    queue.push(entry(items[0], 5));
+    queue.push(entry(items[1], 3));
+    queue.push(entry(items[0], 1));
+    REQUIRE(queue.size() == 2);
+    REQUIRE(queue.tryPop(popped));
+    REQUIRE(popped.value == 1);
+    REQUIRE(queue.tryPop(popped));
+    REQUIRE(popped.value == 3);
+    REQUIRE(!queue.tryPop(popped));
+}
+
+TEST_CASE("SkipListPriorityQueue spray pop test", "[SkipListPriorityQueue]") {
+    constexpr int size = 1000;
+    auto items = makeItems(size);
+
+    Queue queue(threadCount, 8);
+    for (int i = 0; i < size; ++i) {
+        queue.push(entry(items[i], (i * 7919) % size));
+    }
+
+    // Spray pops are relaxed: each one returns one of the first items, but every item comes out exactly once.
+    std::vector<int> values;
+    Entry popped;
+    while (queue.trySprayPop(popped)) {
+        values.push_back(popped.value);
+    }
+
+    REQUIRE(queue.empty());
+    REQUIRE(values.size() == size);
+    REQUIRE(std::find(values.begin(), values.end(), 0) - values.begin() < size / 10);
+
+    std::sort(values.begin(), values.end());
+    REQUIRE(std::adjacent_find(values.begin(), values.end()) == values.end());
+}
+
+TEST_CASE("SkipListPriorityQueue parallel test", "[SkipListPriorityQueue]") {
+    constexpr int perThread = 5000;
+    auto items = makeItems(threadCount * perThread);
+
+    Queue queue(threadCount, 16);
+
+    // Every thread pushes its own items and pops whatever it gets, strictly or sprayed, while it also changes the keys
+    // of its own items that are still queued; an item may be popped by another thread at any time.
+    std::vector<std::vector<TestItem*>> popped(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&queue, &items, &popped, t]() {
+            std::mt19937 random(static_cast<unsigned>(t));
+
+            for (int i = 0; i < perThread; ++i) {
+                queue.push(entry(items[t * perThread + i], static_cast<int>(random() % 100000)));
+
+                Entry entry;
+                if (i % 2 == 0 && (t % 2 == 0 ? queue.tryPop(entry) : queue.trySprayPop(entry))) {
+                    popped[t].push_back(entry.item);
+                }
+
+                const auto& own = items[t * perThread + random() % (i + 1)];
+                queue.update(cserna::entry(own, static_cast<int>(random() % 100000)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<TestItem*> all;
+    for (auto& items : popped) {
+        all.insert(all.end(), items.begin(), items.end());
+    }
+
+    std::vector<int> values;
+    Entry entry;
+    while (queue.tryPop(entry)) {
+        all.push_back(entry.item);
+        values.push_back(entry.value);
+    }
+
+    REQUIRE(queue.empty());
+    REQUIRE(std::is_sorted(values.begin(), values.end()));
+    REQUIRE(all.size() == items.size());
+    std::sort(all.begin(), all.end());
+    REQUIRE(std::unique(all.begin(), all.end()) == all.end());
+    for (auto& item : items) {
+        REQUIRE(item->ticket == Queue::NOT_QUEUED);
+    }
+}
+
+// Counts the copies of entries, which live in the nodes of the queue until the nodes are freed.
+struct CountedEntry : Entry {
+    CountedEntry() { ++live; }
+    CountedEntry(const CountedEntry& other) : Entry(other) { ++live; }
+    CountedEntry& operator=(const CountedEntry&) = default;
+    ~CountedEntry() { --live; }
+
+    static std::atomic<int> live;
+};
+
+std::atomic<int> CountedEntry::live{0};
+
+CountedEntry countedEntry(TestItem* item, const int value) {
+    CountedEntry entry;
+    entry.value = value;
+    entry.item = item;
+    return entry;
+}
+
+TEST_CASE("SkipListPriorityQueue reclamation test", "[SkipListPriorityQueue]") {
+    constexpr int queued = 100;
+    constexpr int pops = 50000;
+    auto items = makeItems(threadCount * queued);
+
+    SECTION("sequential") {
+        SkipListPriorityQueue<CountedEntry, IndexFunction, EntryCompare> queue(1, 4);
+        std::mt19937 random(5);
+        for (int i = 0; i < queued; ++i) {
+            queue.push(countedEntry(items[i].get(), static_cast<int>(random() % 100000)));
+        }
+
+        // The unlinked nodes are freed while the queue is in use, not when it is destroyed.
+        CountedEntry entry;
+        for (int i = 0; i < pops; ++i) {
+            REQUIRE(queue.tryPop(entry));
+            queue.push(countedEntry(entry.item, entry.value + static_cast<int>(random() % 1000)));
+            if (i % 1000 == 0) {
+                REQUIRE(CountedEntry::live < 4 * queued);
+            }
+        }
+    }
+
+    SECTION("parallel") {
+        SkipListPriorityQueue<CountedEntry, IndexFunction, EntryCompare> queue(threadCount, 16);
+        for (int i = 0; i < threadCount * queued; ++i) {
+            queue.push(countedEntry(items[i].get(), i));
+        }
+
+        // Every popped item is pushed back, so the queue keeps its size while the nodes churn.
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&queue, t]() {
+                std::mt19937 random(static_cast<unsigned>(t));
+                CountedEntry entry;
+                for (int i = 0; i < pops / threadCount; ++i) {
+                    if (t % 2 == 0 ? queue.tryPop(entry) : queue.trySprayPop(entry)) {
+                        queue.push(countedEntry(entry.item, entry.value + static_cast<int>(random() % 1000)));
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        // Operations that stall delay the reclamation, but most nodes are freed long before the queue is destroyed.
+        REQUIRE(CountedEntry::live < pops / 2);
+        REQUIRE(queue.size() == threadCount * queued);
+
+        queue.collect();
+        REQUIRE(CountedEntry::live < 2 * threadCount * queued);
+    }
+}
+
+} // namespace
+} // namespace cserna
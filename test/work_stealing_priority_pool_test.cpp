@@ -0,0 +1,206 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+#include "../include/work_stealing_priority_pool.hpp"
+
+namespace cserna {
+namespace {
+
+struct TestItem {
+    explicit TestItem(int value) : value(value) {}
+
+    int value;
+    std::size_t index = std::numeric_limits<std::size_t>::max();
+};
+
+struct IndexFunction {
+    using is_intrusive = std::true_type;
+
+    std::size_t& operator()(TestItem* item) { return item->index; }
+    std::size_t operator()(const TestItem* item) const { return item->index; }
+};
+
+struct ItemCompare {
+    int operator()(const TestItem* lhs, const TestItem* rhs) const {
+        if (lhs->value < rhs->value)
+            return -1;
+        if (lhs->value > rhs->value)
+            return 1;
+        return 0;
+    }
+};
+
+struct KeyFunction {
+    int operator()(const TestItem* item) const { return item->value; }
+};
+
+using Pool = WorkStealingPriorityPool<TestItem*, IndexFunction, ItemCompare, KeyFunction>;
+
+constexpr int threadCount = 4;
+
+std::vector<std::unique_ptr<TestItem>> makeItems(const int size) {
+    std::vector<std::unique_ptr<TestItem>> items;
+    for (int i = 0; i < size; ++i) {
+        items.emplace_back(new TestItem((i * 7919) % size));
+    }
+    return items;
+}
+
+TEST_CASE("WorkStealingPriorityPool sequential test", "[WorkStealingPriorityPool]") {
+    constexpr int size = 1000;
+    auto items = makeItems(size);
+
+    Pool pool(threadCount, 16, 0);
+    REQUIRE(pool.workerCount() == threadCount);
+    REQUIRE(pool.lowerBound() == Pool::emptyKey());
+
+    TestItem* item = nullptr;
+    REQUIRE(!pool.tryPop(0, item));
+    REQUIRE(!pool.steal(0));
+
+    // Everything goes to worker 1.
+    for (auto& item : items) {
+        pool.push(1, item.get());
+    }
+    REQUIRE(pool.size() == size);
+    REQUIRE(pool.size(1) == size);
+    REQUIRE(pool.lowerBound() == 0);
+
+    // Worker 0 is dry, so its first pop steals the best batch of worker 1.
+    REQUIRE(pool.tryPop(0, item));
+    REQUIRE(item->value == 0);
+    REQUIRE(pool.size(0) == 15);
+    REQUIRE(pool.size(1) == size - 16);
+    REQUIRE(pool.lowerBound() == 1);
+
+    // Each worker pops its own items in order.
+    std::vector<int> values;
+    while (pool.size(0) > 0) {
+        REQUIRE(pool.tryPop(0, item));
+        values.push_back(item->value);
+    }
+    REQUIRE(values.size() == 15);
+    REQUIRE(values.front() == 1);
+    REQUIRE(std::is_sorted(values.begin(), values.end()));
+    REQUIRE(pool.lowerBound() == 16);
+
+    values.clear();
+    while (pool.tryPop(1, item)) {
+        values.push_back(item->value);
+    }
+    REQUIRE(values.size() == size - 16);
+    REQUIRE(values.front() == 16);
+    REQUIRE(std::is_sorted(values.begin(), values.end()));
+
+    REQUIRE(pool.empty());
+    REQUIRE(pool.lowerBound() == Pool::emptyKey());
+}
+
+TEST_CASE("WorkStealingPriorityPool rebalancing test", "[WorkStealingPriorityPool]") {
+    constexpr int size = 100;
+    auto items = makeItems(size);
+
+    // The bad half goes to worker 0, the good half to worker 1.
+    Pool pool(2, 8, 4);
+    for (auto& item : items) {
+        pool.push(item->value < size / 2 ? 1 : 0, item.get());
+    }
+
+    // Every fourth pop worker 0 sees the better items of worker 1 and takes a batch of them.
+    TestItem* item = nullptr;
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(pool.tryPop(0, item));
+        REQUIRE(item->value == size / 2 + i);
+    }
+    REQUIRE(pool.tryPop(0, item));
+    REQUIRE(item->value == 0);
+    REQUIRE(pool.size(0) == size / 2 - 3 + 7);
+}
+
+TEST_CASE("WorkStealingPriorityPool parallel test", "[WorkStealingPriorityPool]") {
+    constexpr int perThread = 5000;
+    auto items = makeItems(threadCount * perThread);
+
+    Pool pool(threadCount, 16, 32);
+
+    // Every thread pushes its items to the worker their value hashes to, as in HDA*, and pops from its own worker,
+    // stealing when it runs dry.
+    std::vector<std::vector<TestItem*>> popped(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&pool, &items, &popped, t]() {
+            for (int i = 0; i < perThread; ++i) {
+                TestItem* own = items[t * perThread + i].get();
+                pool.push(static_cast<std::size_t>(own->value * 31 % threadCount), own);
+
+                TestItem* item;
+                if (i % 2 == 0 && pool.tryPop(static_cast<std::size_t>(t), item)) {
+                    popped[t].push_back(item);
+                }
+            }
+
+            TestItem* item;
+            while (pool.tryPop(static_cast<std::size_t>(t), item)) {
+                popped[t].push_back(item);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<TestItem*> all;
+    for (auto& items : popped) {
+        all.insert(all.end(), items.begin(), items.end());
+    }
+
+    REQUIRE(pool.empty());
+    REQUIRE(pool.lowerBound() == Pool::emptyKey());
+    REQUIRE(all.size() == items.size());
+    std::sort(all.begin(), all.end());
+    REQUIRE(std::unique(all.begin(), all.end()) == all.end());
+}
+
+TEST_CASE("WorkStealingPriorityPool lower bound test", "[WorkStealingPriorityPool]") {
+    constexpr int size = 1000;
+    auto items = makeItems(size);
+
+    Pool pool(threadCount, 8, 0);
+    for (auto& item : items) {
+        pool.push(0, item.get());
+    }
+
+    // The best item keeps moving between the workers, but the lower bound never loses sight of it.
+    std::atomic<bool> done{false};
+    std::atomic<int> wrongBounds{0};
+    std::thread monitor([&pool, &done, &wrongBounds]() {
+        while (!done.load()) {
+            if (pool.lowerBound() != 0) {
+                ++wrongBounds;
+            }
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&pool, t]() {
+            for (int i = 0; i < 2000; ++i) {
+                pool.steal(static_cast<std::size_t>(t));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    done.store(true);
+    monitor.join();
+
+    REQUIRE(wrongBounds == 0);
+    REQUIRE(pool.size() == size);
+}
+
+} // namespace
+} // namespace cserna